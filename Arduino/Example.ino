@@ -38,8 +38,12 @@
  * Folder Structure:
  * Example/
  * ├── Example.ino
+ * ├── SpiBus.cpp
+ * ├── SpiBus.h
  * ├── SpiFrame.cpp
  * ├── SpiFrame.h
+ * ├── TcpRelay.cpp
+ * ├── TcpRelay.h
  * ├── W5500.cpp
  * ├── W5500.h
  * 
@@ -56,6 +60,7 @@
 
 #include "W5500.h"
 #include "SpiFrame.h"
+#include "TcpRelay.h"
 
 
 // SPI Frame
@@ -89,6 +94,14 @@ const uint16_t socket0_port = 1234;
 const uint16_t socket1_port = 3210;
 const uint16_t socket2_port = 22;
 
+// Maximum time to wait for the other side to accept relayed TCP data
+const float relay_timeout = 1.0; // seconds
+
+// Socket 2 relay (eth1 <-> eth2), only reads as much as the other side can take
+uint8_t ssh_buffer[1000];
+TcpRelay ssh_relay(eth1, 2, eth2, 2, ssh_buffer, sizeof(ssh_buffer));
+bool ssh_active = false; // connection accepted on eth1, relay running until both directions are closed
+
 
 // Helper Functions for nicely formatted Serial prints
 void SerialPrintIP(W5500::IP_t ip);
@@ -220,6 +233,10 @@ void loop()
     // Software buffer for data relay
     uint8_t buffer[1000];
 
+    // Maintenance of both interfaces (e.g. complete a non-blocking close)
+    eth1.poll();
+    eth2.poll();
+
     //===================================================================
     //=== Socket 0 - Track status and print verbose status changes
 
@@ -258,8 +275,8 @@ void loop()
         Serial.print("eth1 (socket 0) - TCP received: ");
         Serial.write(buffer, len);
         Serial.println();
-        // send to eth2
-        eth2.send(0, buffer, len);
+        // send to eth2 (wait for free space in the TX buffer)
+        eth2.sendAll(0, buffer, len, relay_timeout);
     }
 
     if (eth2.receiveAvailable(0) > 0) {
@@ -269,8 +286,8 @@ void loop()
         Serial.print("eth2 (socket 0) - TCP received: ");
         Serial.write(buffer, len);
         Serial.println();
-        // send to eth1
-        eth1.send(0, buffer, len);
+        // send to eth1 (wait for free space in the TX buffer)
+        eth1.sendAll(0, buffer, len, relay_timeout);
     }
 
     if (Serial.available() > 0) {
@@ -310,33 +327,52 @@ void loop()
     //===================================================================
     //=== Socket 2 - Forwarding TCP Port 22 (ssh) from eth1 to eth2
 
-    // Keep TCP server (eth1) open, but only connect eth2 if the someone connects to eth1 (TCP server)
-    eth1.socketKeepOpen(2, W5500::TCP_Server);
-    switch(eth1.socketStatus(2)){
-        case W5500::Closed:
-        case W5500::TCP_Listen:
-            // no connection on eth1 -> close connection on eth2
-            eth2.socketClose(2);
-            break;
-        case W5500::TCP_Connected:
-            // active connection on eth1 -> open connection on eth2
-            eth2.socketKeepOpen(2, W5500::TCP_Client); // won't harm if already open
-            break;
-        case W5500::Temporary:
-        default:
-            // do nothing
-            break;
+    // Keep TCP server (eth1) listening, but only connect eth2 if someone connects to eth1 (TCP server)
+    // The TCP state is used without maintenance (unlike "socketStatus"), so a half-closed connection is not
+    // disconnected before the relay has forwarded all data & the FIN of each direction
+    if (! ssh_active) {
+        const W5500::OpenState open_state = eth1.openState(2);
+        const bool opening = (open_state == W5500::Open_Closing) || (open_state == W5500::Open_Init) || (open_state == W5500::Open_Connecting);
+        switch(eth1.tcpState(2)){
+            case W5500::TCP_Closed:
+                // listen again, once the previous connection is closed (non-blocking, see "poll")
+                if (! opening && ! eth1.socketClosing(2)) {
+                    eth1.socketOpenAsync(2, W5500::TCP_Server);
+                }
+                break;
+            case W5500::TCP_Established:
+            case W5500::TCP_PeerClosed:
+                // connection on eth1 -> open connection on eth2
+                eth2.socketOpenAsync(2, W5500::TCP_Client);
+                ssh_relay.reset();
+                ssh_active = true;
+                break;
+            default:
+                // listening, opening or closing -> do nothing
+                break;
+        }
     }
 
-    // Relay data between eth1 & eth2, only if both are connected
-    if (eth1.socketConnected(2) && eth2.socketConnected(2)) {
-        if (eth1.receiveAvailable(2) > 0) {
-            int len = eth1.receive(2, buffer, sizeof(buffer));
-            eth2.send(2, buffer, len);
-        }
-        if (eth2.receiveAvailable(2) > 0) {
-            int len = eth2.receive(2, buffer, sizeof(buffer));
-            eth1.send(2, buffer, len);
+    // Relay data between eth1 & eth2 until both directions are closed, then close both sockets
+    if (ssh_active) {
+        switch(eth2.openState(2)){
+            case W5500::Open_Established:
+                ssh_relay.poll();
+                if (ssh_relay.finished()) {
+                    eth1.socketCloseAsync(2);
+                    eth2.socketCloseAsync(2);
+                    ssh_active = false;
+                }
+                break;
+            case W5500::Open_Failed:
+            case W5500::Open_Idle:
+                // eth2 could not connect -> close the connection on eth1
+                eth1.socketCloseAsync(2);
+                ssh_active = false;
+                break;
+            default:
+                // eth2 still connecting
+                break;
         }
     }
 }
@@ -0,0 +1,232 @@
+#include "SpiBus.h"
+
+/**
+ * @brief Constructor
+ * @param spi SPI peripheral of this bus (default: `SPI`)
+ */
+SpiBus::SpiBus(SPIClass &spi) : spi_peripheral(spi) {
+#ifdef INC_FREERTOS_H
+    state_lock = xSemaphoreCreateMutexStatic(&state_lock_buffer);
+    for (uint8_t client = 0; client < Client_MAX; client++) {
+        turn[client] = xSemaphoreCreateBinaryStatic(&turn_buffer[client]);
+    }
+#endif
+    for (uint8_t client = 0; client < Client_MAX; client++) {
+        waiting[client] = 0;
+    }
+    resetStats();
+}
+
+/**
+ * @brief Bus manager of the default SPI peripheral (`SPI`)
+ * @return shared bus manager, used by `SpiFrame` unless another bus is given
+ */
+SpiBus &SpiBus::shared() {
+    static SpiBus bus;
+    return bus;
+}
+
+/**
+ * @brief Initialize the SPI peripheral (only once, for all clients)
+ */
+void SpiBus::begin() {
+    if (started) {
+        return;
+    }
+    spi().begin();
+    started = true;
+}
+
+/**
+ * @brief Register a client (chip) on the bus
+ * @param settings SPI settings used while the client holds the bus
+ * @param priority Higher priority clients are served first if multiple clients are waiting
+ * @param weight Share of the bus between clients of the same priority (relative, must not be 0)
+ * @return client number, `No_Client` if too many clients are registered
+ */
+uint8_t SpiBus::attach(const SPISettings &settings, uint8_t priority, uint8_t weight) {
+    if (clients >= Client_MAX) {
+        return No_Client;
+    }
+    const uint8_t client = clients++;
+    this->settings[client] = settings;
+    virtual_time[client] = bus_virtual_time;
+    setPriority(client, priority, weight);
+    return client;
+}
+
+/**
+ * @brief Change priority & weight of a client
+ * @param client Client number (see "attach")
+ * @param priority Higher priority clients are served first if multiple clients are waiting
+ * @param weight Share of the bus between clients of the same priority (relative, must not be 0)
+ */
+void SpiBus::setPriority(uint8_t client, uint8_t priority, uint8_t weight) {
+    if (client >= clients) {
+        return;
+    }
+    this->priority[client] = priority;
+    this->weight[client] = weight > 0 ? weight : 1;
+}
+
+
+//=======================================================
+// Bus access
+//=======================================================
+
+/**
+ * @brief Wait until the client is granted the bus & configure the SPI peripheral for it
+ * @param client Client number (see "attach")
+ * @return true if the bus was acquired, false if the client is not attached (e.g. `No_Client`)
+ * Without concurrent tasks, the bus is always granted immediately. Otherwise blocks until "release" hands the bus over.
+ */
+bool SpiBus::acquire(uint8_t client) {
+    if (client >= clients) {
+        return false;
+    }
+    const uint32_t start_us = micros();
+
+    lock();
+    // an idle client does not gain credit - continue at the current virtual time of the bus
+    if ( (waiting[client] == 0) && (static_cast<int32_t>(virtual_time[client] - bus_virtual_time) < 0) ) {
+        virtual_time[client] = bus_virtual_time;
+    }
+    waiting[client]++;
+    while ( (current != No_Client) || (nextClient() != client) ) {
+        waitTurn(client);
+    }
+    waiting[client]--;
+    current = client;
+    bus_virtual_time = virtual_time[client];
+    unlock();
+
+    acquired_us = micros();
+    client_stats[client].wait_us += acquired_us - start_us;
+    spi().beginTransaction(settings[client]);
+    return true;
+}
+
+/**
+ * @brief Release the bus after a SPI frame
+ * @param client Client number (see "attach")
+ * @param bytes Number of bytes transferred in the frame
+ */
+void SpiBus::release(uint8_t client, uint16_t bytes) {
+    if (client >= clients) {
+        return; // not attached - the bus was not acquired
+    }
+    spi().endTransaction();
+
+    Stats &stats = client_stats[client];
+    stats.frames++;
+    stats.bytes += bytes;
+    stats.busy_us += micros() - acquired_us;
+
+    lock();
+    // scaled, so that low weights still advance the virtual time with small frames
+    virtual_time[client] += (static_cast<uint32_t>(bytes) << 8) / weight[client];
+    current = No_Client;
+    handOver();
+    unlock();
+}
+
+// SPI peripheral of this bus (only to be used while holding the bus)
+SPIClass &SpiBus::spi() {
+    return spi_peripheral;
+}
+
+// waiting client to be served next: highest priority, then lowest virtual time
+uint8_t SpiBus::nextClient() const {
+    uint8_t next = No_Client;
+    for (uint8_t client = 0; client < clients; client++) {
+        if (waiting[client] == 0) {
+            continue;
+        }
+        if ( (next == No_Client) || (priority[client] > priority[next])
+                || ( (priority[client] == priority[next]) && (static_cast<int32_t>(virtual_time[client] - virtual_time[next]) < 0) ) ) {
+            next = client;
+        }
+    }
+    return next;
+}
+
+
+//=======================================================
+// Locking
+//=======================================================
+
+#ifdef INC_FREERTOS_H
+// lock the bus state (mutex - also excludes tasks on other cores)
+void SpiBus::lock() {
+    xSemaphoreTake(state_lock, portMAX_DELAY);
+}
+
+void SpiBus::unlock() {
+    xSemaphoreGive(state_lock);
+}
+
+// block until the bus is handed over to the client (lock is released while waiting)
+void SpiBus::waitTurn(uint8_t client) {
+    if (current == No_Client) {
+        // bus free, but another client is next (e.g. priority changed since the release) - make sure it is woken
+        handOver();
+    }
+    unlock();
+    xSemaphoreTake(turn[client], portMAX_DELAY);
+    lock();
+}
+
+// wake the waiting client to be served next (bus was released)
+void SpiBus::handOver() {
+    const uint8_t next = nextClient();
+    if (next != No_Client) {
+        xSemaphoreGive(turn[next]);
+    }
+}
+#else
+// lock the bus state (single core - disable interrupts)
+void SpiBus::lock() {
+    noInterrupts();
+}
+
+void SpiBus::unlock() {
+    interrupts();
+}
+
+// let the client holding the bus continue (lock is released while waiting)
+void SpiBus::waitTurn(uint8_t) {
+    unlock();
+    yield();
+    lock();
+}
+
+// waiting clients check the bus state themselves
+void SpiBus::handOver() {
+}
+#endif
+
+
+//=======================================================
+// Status
+//=======================================================
+
+// client currently holding the bus, `No_Client` if the bus is free
+uint8_t SpiBus::holder() const {
+    return current;
+}
+
+// bus occupancy statistics of a client (all 0 if not attached)
+const SpiBus::Stats &SpiBus::stats(uint8_t client) const {
+    static const Stats none = {0, 0, 0, 0};
+    if (client >= clients) {
+        return none;
+    }
+    return client_stats[client];
+}
+
+// reset the statistics of all clients
+void SpiBus::resetStats() {
+    for (uint8_t client = 0; client < Client_MAX; client++) {
+        client_stats[client] = Stats{0, 0, 0, 0};
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef SPI_BUS_H
+#define SPI_BUS_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#ifdef INC_FREERTOS_H
+#if __has_include(<freertos/semphr.h>)
+#include <freertos/semphr.h>
+#else
+#include <semphr.h>
+#endif
+#endif
+
+// ARDUINO Implementation of `SpiBus` class, shared by all `SpiFrame` objects on one SPI peripheral
+
+/**
+ * @brief SPI Bus Manager
+ * 
+ * Owns one SPI peripheral and arbitrates it between multiple chips (clients, one per `SpiFrame`).
+ * Create one bus per SPI peripheral (e.g. `SPI`, `SPI1`) to operate multiple buses in parallel (see `BusWorker`).
+ * The bus is held for a single SPI frame. If multiple clients are waiting (e.g. RTOS tasks),
+ * the client with the highest priority is served first. Clients of the same priority share the bus
+ * weighted fair by the number of bytes transferred.
+ * FreeRTOS: the bus state is guarded by a mutex (also between cores) & waiting clients block until the bus
+ * is handed over to them. Otherwise (single core, no RTOS) interrupts are disabled & waiting clients yield.
+ * Bus occupancy statistics are tracked for each client.
+ */
+class SpiBus {
+public:
+    //=============================
+    // Type Definitions
+
+    struct Stats {
+        uint32_t frames;    // number of SPI frames
+        uint32_t bytes;     // bytes transferred (incl. 3-byte frame header)
+        uint32_t busy_us;   // time holding the bus
+        uint32_t wait_us;   // time waiting for the bus (held by another client)
+    };
+
+    //-----------------------------
+    // Constants
+    static constexpr uint8_t Client_MAX = 16;
+    static constexpr uint8_t No_Client = 0xFF;
+
+    //=============================
+    // Constructor
+
+    SpiBus(SPIClass &spi = SPI);
+    static SpiBus &shared();
+
+    //=============================
+    // Functions
+
+    void begin();
+    uint8_t attach(const SPISettings &settings, uint8_t priority = 0, uint8_t weight = 1);
+    void setPriority(uint8_t client, uint8_t priority, uint8_t weight);
+
+    // Bus access for a single SPI frame
+    bool acquire(uint8_t client);
+    void release(uint8_t client, uint16_t bytes);
+    SPIClass &spi();
+
+    // Status
+    uint8_t holder() const;
+    const Stats &stats(uint8_t client) const;
+    void resetStats();
+
+private:
+    //=============================
+    // Variables
+
+    SPIClass &spi_peripheral;
+    bool started = false;
+    uint8_t clients = 0;
+    // Bus state - only changed with the lock held (see "lock")
+    uint8_t current = No_Client;            // client holding the bus
+    uint8_t waiting[Client_MAX];            // number of tasks waiting for the bus per client
+
+#ifdef INC_FREERTOS_H
+    // Lock of the bus state & handover of the bus to a waiting client (one semaphore per client)
+    SemaphoreHandle_t state_lock;
+    StaticSemaphore_t state_lock_buffer;
+    SemaphoreHandle_t turn[Client_MAX];
+    StaticSemaphore_t turn_buffer[Client_MAX];
+#endif
+
+    // Client configuration
+    SPISettings settings[Client_MAX];
+    uint8_t priority[Client_MAX];
+    uint8_t weight[Client_MAX];
+
+    // Weighted fair sharing - virtual time advances by bytes / weight while holding the bus
+    uint32_t virtual_time[Client_MAX];
+    uint32_t bus_virtual_time = 0;
+
+    // Statistics
+    Stats client_stats[Client_MAX];
+    uint32_t acquired_us = 0;
+
+    //=============================
+    // Functions
+
+    uint8_t nextClient() const;
+
+    // Locking of the bus state
+    void lock();
+    void unlock();
+    void waitTurn(uint8_t client);
+    void handOver();
+};
+
+#endif // SPI_BUS_H
@@ -1,17 +1,29 @@
 #include "SpiFrame.h"
 
-// Constructor
-SpiFrame::SpiFrame(pin_size_t cs) : cs(cs) {}
+/**
+ * @brief Constructor
+ * @param cs Chip-select pin
+ * @param bus SPI bus the W5500 is connected to (default: `SPI`)
+ * @param priority Bus priority of this chip, higher priority is served first if multiple chips are waiting
+ * @param weight Share of the bus between chips of the same priority (relative)
+ */
+SpiFrame::SpiFrame(pin_size_t cs, SpiBus &bus, uint8_t priority, uint8_t weight)
+    : cs(cs), bus(bus), priority(priority), weight(weight) {}
 
 /**
  * @brief Initialize the SPI communication
+ * @return false if the chip could not be attached to the bus (more than `SpiBus::Client_MAX` chips)
+ * Without a client number, all transfers are skipped (no bus access).
  */
-void SpiFrame::init() {
+bool SpiFrame::init() {
     pinMode(cs, OUTPUT);
     digitalWrite(cs, HIGH); // Deselect the SPI device
     
-    SPI.begin();
-    SPI.beginTransaction(w5500_spi_settings);
+    bus.begin();
+    if (client == SpiBus::No_Client) {
+        client = bus.attach(w5500_spi_settings, priority, weight);
+    }
+    return client != SpiBus::No_Client;
 }
 
 
@@ -22,13 +34,39 @@ void SpiFrame::init() {
  * @param len Length of the data
  */
 void SpiFrame::transfer(Frame frame, uint8_t *data, uint16_t len) {
+    if (! bus.acquire(client)) {
+        return; // not attached to the bus (see "init")
+    }
+    SPIClass &spi = bus.spi();
     digitalWrite(cs, LOW); // Select the SPI device
     // W5500: CS Setup Time = 5 ns
-    SPI.transfer16(frame.offset_addr);
-    SPI.transfer( (frame.socket_n<<2 | frame.bsb) << 3 | frame.rw << 2); // variable length data mode (VDM)
-    SPI.transfer(data, len);
+    spi.transfer16(frame.offset_addr);
+    spi.transfer( (frame.socket_n<<2 | frame.bsb) << 3 | frame.rw << 2); // variable length data mode (VDM)
+    spi.transfer(data, len);
     // W5500: CS Hold Time = 5 ns
     digitalWrite(cs, HIGH); // Deselect the SPI device   
+    bus.release(client, len + 3);
+}
+
+/**
+ * @brief Start a transfer, which may continue in the background (e.g. DMA) until "transfer_wait"
+ * @param frame Frame to transfer
+ * @param data Data to write & read back (must stay valid until "transfer_wait")
+ * @param len Length of the data
+ * Allows overlapping transfers of W5500s on different SPI buses (see "W5500::pipeTo").
+ * This implementation transfers synchronously, as the Arduino SPI library has no asynchronous transfer.
+ * An asynchronous (DMA) implementation must release the bus when the transfer is completed
+ * & complete a previous transfer of the same SpiFrame before starting the next one.
+ */
+void SpiFrame::transfer_start(Frame frame, uint8_t *data, uint16_t len) {
+    transfer(frame, data, len);
+}
+
+/**
+ * @brief Wait for the transfer started with "transfer_start" to complete
+ */
+void SpiFrame::transfer_wait() {
+    // synchronous transfer - already completed
 }
 
 /**
@@ -40,23 +78,100 @@ void SpiFrame::transfer(Frame frame, uint8_t *data, uint16_t len) {
  * @return true if the value was found, false if the timeout was reached
  */
 bool SpiFrame::wait_for_value(Frame frame, uint8_t mask, uint8_t value, float timeout_seconds) {
-    const unsigned long start_time = millis();
+    const uint32_t start_time = time_ms();
 
-    while ( (millis() - start_time) < static_cast<unsigned long>(timeout_seconds * 1000)) {
+    while ( (time_ms() - start_time) < static_cast<uint32_t>(timeout_seconds * 1000)) {
         uint8_t data;
         transfer(frame, &data, 1);
         if ( (data & mask) == value) {
             return true;
         }
-        delay(1);
+        pause(1);
     }
     return false;
 }
 
+/**
+ * @brief Wait for any of the masked bits to be set in a register, with a timeout
+ * @param frame Frame to read from (only a single byte)
+ * @param mask Bits to wait for
+ * @param timeout_seconds Timeout in seconds
+ * @return the masked read value (bits set), 0 if the timeout was reached
+ */
+uint8_t SpiFrame::wait_for_any(Frame frame, uint8_t mask, float timeout_seconds) {
+    const uint32_t start_time = time_ms();
+
+    while ( (time_ms() - start_time) < static_cast<uint32_t>(timeout_seconds * 1000)) {
+        uint8_t data;
+        transfer(frame, &data, 1);
+        if ( (data & mask) != 0) {
+            return data & mask;
+        }
+        pause(1);
+    }
+    return 0;
+}
+
 /**
  * @brief Sleep for a specific amount of time
  * @param seconds Time to sleep in seconds
  */
 void SpiFrame::sleep(float seconds) {
-    delay(static_cast<unsigned long>(seconds * 1000));
+    pause(static_cast<uint32_t>(seconds * 1000));
+}
+
+/**
+ * @brief Get the current time (e.g. for timeouts of host-side buffering)
+ * @return Time in milliseconds since startup (wraps around, compare differences only)
+ * All waits & timeouts are measured with this clock.
+ */
+uint32_t SpiFrame::time_ms() {
+    return millis();
+}
+
+/**
+ * @brief Let other tasks run while waiting (e.g. between chunks of a long transfer)
+ * Calls the wait hook (with wait_ms = 0) if set.
+ */
+void SpiFrame::yield() {
+    if (wait_hook != nullptr) {
+        wait_hook(0, wait_context);
+    } else {
+        ::yield();
+    }
+}
+
+/**
+ * @brief Set a hook called during every wait ("sleep", "wait_for_value", "wait_for_any", "yield")
+ * @param hook function called with the time (ms) still to wait, nullptr: use `delay` (blocking)
+ * @param context passed to the hook (e.g. a dispatcher or RTOS task)
+ * The hook may run other work (e.g. "initStep" / "poll" of other chips), block the task (e.g. `vTaskDelay`)
+ * or advance a simulated clock. It is called repeatedly until the wait time passed (according to "time_ms").
+ * The hook must not access this chip.
+ */
+void SpiFrame::set_wait_hook(WaitHook hook, void *context) {
+    wait_hook = hook;
+    wait_context = context;
+}
+
+// wait via the hook (if set) or delay
+void SpiFrame::pause(uint32_t ms) {
+    if (wait_hook == nullptr) {
+        delay(ms);
+        return;
+    }
+    const uint32_t start_time = time_ms();
+    uint32_t elapsed = 0;
+    do {
+        wait_hook(ms - elapsed, wait_context);
+        elapsed = time_ms() - start_time;
+    } while (elapsed < ms);
+}
+
+/**
+ * @brief Bus occupancy statistics of this W5500
+ * @return statistics of the shared SPI bus for this chip
+ */
+const SpiBus::Stats &SpiFrame::stats() {
+    return bus.stats(client);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <SPI.h>
+#include "SpiBus.h"
 
 // ARDUINO Implementation of `SpiFrame` class, used by the W5500 class
 
@@ -24,19 +25,41 @@ public:
         BlockSelect bsb;
         ReadWrite rw;
     };
+    // Called during every wait instead of `delay` / `yield` (see `set_wait_hook`)
+    using WaitHook = void (*)(uint32_t wait_ms, void *context);
 
     // Constructor
-    SpiFrame(pin_size_t cs);
-    void init();
+    SpiFrame(pin_size_t cs, SpiBus &bus = SpiBus::shared(), uint8_t priority = 0, uint8_t weight = 1);
+    bool init();
     
     void transfer(Frame frame, uint8_t *data, uint16_t len);
+    void transfer_start(Frame frame, uint8_t *data, uint16_t len);
+    void transfer_wait();
     bool wait_for_value(Frame frame, uint8_t mask, uint8_t value, float timeout_seconds);
+    uint8_t wait_for_any(Frame frame, uint8_t mask, float timeout_seconds);
     void sleep(float seconds);
+    uint32_t time_ms();
+    void yield();
+    void set_wait_hook(WaitHook hook, void *context = nullptr);
+
+    const SpiBus::Stats &stats();
 
 private:
     const SPISettings w5500_spi_settings = SPISettings(33e6, MSBFIRST, SPI_MODE0); // 33 MHz
 
     pin_size_t cs;
+
+    // Shared SPI bus & client number on it
+    SpiBus &bus;
+    uint8_t client = SpiBus::No_Client;
+    const uint8_t priority;
+    const uint8_t weight;
+
+    // Cooperative waiting (nullptr: delay)
+    WaitHook wait_hook = nullptr;
+    void *wait_context = nullptr;
+
+    void pause(uint32_t ms);
 };
 
 #endif // SPI_FRAME_H
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "BusWorker.h"
+
+/**
+ * @brief Add a service task (before starting the worker)
+ * @param task Function called repeatedly by the worker
+ * @param context Parameter of the task (e.g. a relay object)
+ * @return true if added, false if the maximum number of tasks is reached
+ */
+bool BusWorker::addTask(Task task, void *context) {
+    if (task_count >= Task_MAX) {
+        return false;
+    }
+    tasks[task_count] = task;
+    contexts[task_count] = context;
+    task_count++;
+    return true;
+}
+
+/**
+ * @brief Run each service task once (e.g. from the main loop, without a dedicated task / thread)
+ * @return true if any task had work
+ */
+bool BusWorker::runOnce() {
+    bool busy = false;
+    for (uint8_t i = 0; i < task_count; i++) {
+        busy |= tasks[i](contexts[i]);
+    }
+    return busy;
+}
+
+/**
+ * @brief Run the service tasks until "stop" is called
+ * Returns immediately if "stop" was called before (e.g. before the RTOS task started).
+ */
+void BusWorker::run() {
+    serve();
+}
+
+// stop "run" after the current pass of the service tasks (may be called from another task)
+void BusWorker::stop() {
+    keep_running = false;
+}
+
+// true while "run" is executing
+bool BusWorker::running() const {
+    return active;
+}
+
+/**
+ * @brief Entry point for an RTOS task, e.g. `xTaskCreate(BusWorker::taskEntry, "spi1", 1024, &worker, 1, nullptr)`
+ * @param worker Pointer to the BusWorker
+ */
+void BusWorker::taskEntry(void *worker) {
+    static_cast<BusWorker *>(worker)->run();
+#ifdef INC_FREERTOS_H
+    // a FreeRTOS task must not return
+    vTaskDelete(nullptr);
+#endif
+}
+
+// run the service tasks while "keep_running" is set - give up the CPU if no task had work
+void BusWorker::serve() {
+    active = true;
+    while (keep_running) {
+        if (! runOnce()) {
+            idle();
+        }
+    }
+    active = false;
+}
+
+// let other tasks / threads run (e.g. lower priority RTOS tasks & the idle task)
+void BusWorker::idle() {
+#if defined(INC_FREERTOS_H)
+    vTaskDelay(1);
+#elif defined(ARDUINO)
+    yield();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+#ifndef ARDUINO
+/**
+ * @brief Run the worker in its own thread (host builds)
+ * @return true if started, false if already running (call "join" before starting again)
+ */
+bool BusWorker::start() {
+    if (thread.joinable()) {
+        return false;
+    }
+    keep_running = true;
+    thread = std::thread([this] {
+        serve();
+    });
+    return true;
+}
+
+/**
+ * @brief Stop the worker thread & wait for it to finish
+ */
+void BusWorker::join() {
+    stop();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+#endif
@@ -0,0 +1,78 @@
+#ifndef BUS_WORKER_H
+#define BUS_WORKER_H
+
+#include <stdint.h>
+#include <atomic>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <thread>
+#endif
+
+
+/**
+ * @brief Worker servicing all chips of one SPI bus
+ * 
+ * Each SPI bus gets its own worker, running the service tasks of its chips (e.g. relay polling) in a loop.
+ * Workers of different buses run in parallel: a `std::thread` on host builds (Linux),
+ * an RTOS task on the target (create the task with `BusWorker::taskEntry` and the worker as parameter).
+ * A chip (W5500 object) must only be accessed by the worker of its bus,
+ * data between buses is handed over with `SpscQueue` (one queue per direction).
+ * If no task had work in a pass, the worker gives up the CPU (FreeRTOS: blocks for one tick, otherwise yields).
+ */
+class BusWorker {
+public:
+    //=============================
+    // Type Definitions
+
+    // Service task, called repeatedly by the worker - returns true if it had work (e.g. data was relayed)
+    using Task = bool (*)(void *context);
+
+    //-----------------------------
+    // Constants
+    static constexpr uint8_t Task_MAX = 8;
+
+    //=============================
+    // Functions
+
+    bool addTask(Task task, void *context);
+
+    // Run the service tasks
+    bool runOnce();
+    void run();
+    void stop();
+    bool running() const;
+
+    // Entry point for an RTOS task (parameter: BusWorker*)
+    static void taskEntry(void *worker);
+
+#ifndef ARDUINO
+    // Run the worker in its own thread
+    bool start();
+    void join();
+#endif
+
+private:
+    //=============================
+    // Variables
+
+    Task tasks[Task_MAX];
+    void *contexts[Task_MAX];
+    uint8_t task_count = 0;
+
+    std::atomic<bool> keep_running{true};   // cleared by "stop" (also if called before "run" started)
+    std::atomic<bool> active{false};        // "run" / worker thread executing
+
+#ifndef ARDUINO
+    std::thread thread;
+#endif
+
+    //=============================
+    // Functions
+
+    void serve();
+    static void idle();
+};
+
+#endif // BUS_WORKER_H
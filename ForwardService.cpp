@@ -0,0 +1,270 @@
+#include "ForwardService.h"
+
+#include <new>
+#include <string.h>
+#include <algorithm>
+
+/**
+ * @brief Constructor
+ * @param chips Array of W5500 pointers (must remain valid during the lifetime of the service)
+ * @param chip_count Number of chips in the array (max. Chip_MAX)
+ * @param rules Rule table (must remain valid, see "validRules")
+ * @param rule_count Number of rules (max. Rule_MAX)
+ * @param buffer buffer for relaying (shared by all rules)
+ * @param buffer_len size of the buffer
+ */
+ForwardService::ForwardService(W5500 *chips[], uint8_t chip_count, const ForwardRule rules[], uint8_t rule_count, uint8_t *buffer, uint16_t buffer_len)
+    : chips(chips), chip_count(std::min(chip_count, Chip_MAX)), rules(rules), rule_count(std::min(rule_count, Rule_MAX)),
+      buffer(buffer), buffer_len(buffer_len) {}
+
+/**
+ * @brief Allocate & configure the sockets of all rules, open the listeners
+ * @return true if successful, false if a socket could not be allocated (see "W5500::allocateSocket")
+ * The chips must be initialized & configured (see "W5500::setInterfaceNetwork") before.
+ * The free sockets of the chips used by the rules get no buffer memory (0 kB), so the rule buffers fit (see "validRules").
+ */
+bool ForwardService::begin() {
+    uint8_t used_chips = 0;
+    for (uint8_t i = 0; i < rule_count; i++) {
+        if ((rules[i].listen_chip < chip_count) && (rules[i].target_chip < chip_count)) {
+            used_chips |= (1 << rules[i].listen_chip) | (1 << rules[i].target_chip);
+        }
+    }
+    for (uint8_t chip = 0; chip < chip_count; chip++) {
+        if ((used_chips & (1 << chip)) == 0) {
+            continue;
+        }
+        W5500 &eth = *chips[chip];
+        const uint8_t free_mask = eth.freeSockets();
+        for (uint8_t socket_n = 0; socket_n < W5500::Socket_MAX; socket_n++) {
+            if (free_mask & (1 << socket_n)) {
+                eth.setBufferSizeRx(socket_n, 0);
+                eth.setBufferSizeTx(socket_n, 0);
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < rule_count; i++) {
+        const ForwardRule &rule = rules[i];
+        RuleState &state = states[i];
+        if ((rule.listen_chip >= chip_count) || (rule.target_chip >= chip_count)) {
+            return false;
+        }
+        W5500 &listen_eth = *chips[rule.listen_chip];
+        W5500 &target_eth = *chips[rule.target_chip];
+        if (!listen_eth.allocateSocket(state.listen_socket)) {
+            return false;
+        }
+        if (!target_eth.allocateSocket(state.target_socket)) {
+            listen_eth.releaseSocket(state.listen_socket);
+            return false;
+        }
+        const uint8_t buffer_kB = (rule.buffer_kB == 0) ? Default_Buffer_kB : rule.buffer_kB;
+        listen_eth.setBufferSizeRx(state.listen_socket, buffer_kB);
+        listen_eth.setBufferSizeTx(state.listen_socket, buffer_kB);
+        target_eth.setBufferSizeRx(state.target_socket, buffer_kB);
+        target_eth.setBufferSizeTx(state.target_socket, buffer_kB);
+        listen_eth.setSocketSource(state.listen_socket, rule.listen_port);
+        target_eth.setSocketSource(state.target_socket, rule.source_port);
+        target_eth.setSocketDest(state.target_socket, rule.target_ip, rule.target_port);
+        if (rule.protocol == ForwardRule::TCP) {
+            new (relay_storage[i]) TcpRelay(listen_eth, state.listen_socket, target_eth, state.target_socket, buffer, buffer_len);
+        }
+        rules_started = i + 1;
+        openListener(i);
+    }
+    last_check = (chip_count > 0) ? chips[0]->timeMs() : 0;
+    return true;
+}
+
+/**
+ * @brief Service all rules (call regularly)
+ * One read of the common socket interrupt register per chip. Only rules with socket events,
+ * data still to relay or a pending status check (every Check_Interval_ms) access their sockets.
+ */
+void ForwardService::poll() {
+    if (chip_count == 0) {
+        return;
+    }
+    uint8_t pending[Chip_MAX];
+    for (uint8_t c = 0; c < chip_count; c++) {
+        chips[c]->poll();
+        pending[c] = chips[c]->pendingEvents();
+    }
+    const uint32_t now = chips[0]->timeMs();
+    const bool check = (now - last_check) >= Check_Interval_ms;
+    if (check) {
+        last_check = now;
+    }
+
+    for (uint8_t i = 0; i < rules_started; i++) {
+        const ForwardRule &rule = rules[i];
+        RuleState &state = states[i];
+        uint8_t listen_events = 0;
+        uint8_t target_events = 0;
+        if (pending[rule.listen_chip] & (1 << state.listen_socket)) {
+            listen_events = chips[rule.listen_chip]->socketEvents(state.listen_socket);
+        }
+        if (pending[rule.target_chip] & (1 << state.target_socket)) {
+            target_events = chips[rule.target_chip]->socketEvents(state.target_socket);
+        }
+        if (!listen_events && !target_events && !state.active && !state.connecting && !check) {
+            continue;
+        }
+        switch (rule.protocol) {
+            case ForwardRule::TCP:
+                pollTcp(i);
+                break;
+            case ForwardRule::UDP:
+                pollUdp(i, check);
+                break;
+        }
+    }
+}
+
+// upstream of a TCP rule is connected (a client is being served)
+bool ForwardService::connected(uint8_t rule_index) const {
+    return (rule_index < rule_count) && states[rule_index].connected;
+}
+
+// relay of a TCP rule (e.g. for throughput statistics), nullptr for UDP rules & before "begin"
+const TcpRelay *ForwardService::relay(uint8_t rule_index) const {
+    if ((rule_index >= rules_started) || (rules[rule_index].protocol != ForwardRule::TCP)) {
+        return nullptr;
+    }
+    return reinterpret_cast<const TcpRelay *>(relay_storage[rule_index]);
+}
+
+
+//=======================================================
+// Private Functions
+//=======================================================
+
+TcpRelay &ForwardService::tcpRelay(uint8_t rule_index) {
+    return *reinterpret_cast<TcpRelay *>(relay_storage[rule_index]);
+}
+
+// open the listening socket (TCP server) or both sockets (UDP)
+void ForwardService::openListener(uint8_t rule_index) {
+    const ForwardRule &rule = rules[rule_index];
+    const RuleState &state = states[rule_index];
+    switch (rule.protocol) {
+        case ForwardRule::TCP:
+            chips[rule.listen_chip]->socketOpen(state.listen_socket, W5500::TCP_Server);
+            // idle connections are checked by the W5500 (e.g. dropped by a stateful firewall) - set after each open
+            if (rule.keep_alive != 0) {
+                chips[rule.listen_chip]->setKeepAlive(state.listen_socket, rule.keep_alive);
+            }
+            break;
+        case ForwardRule::UDP:
+            chips[rule.listen_chip]->socketOpen(state.listen_socket, W5500::UDP);
+            chips[rule.target_chip]->socketOpen(state.target_socket, W5500::UDP);
+            break;
+    }
+}
+
+// TCP: connect upstream when a client connected, relay, close both sides & listen again when finished
+void ForwardService::pollTcp(uint8_t rule_index) {
+    const ForwardRule &rule = rules[rule_index];
+    RuleState &state = states[rule_index];
+    W5500 &listen_eth = *chips[rule.listen_chip];
+    W5500 &target_eth = *chips[rule.target_chip];
+    TcpRelay &relay = tcpRelay(rule_index);
+
+    if (state.connecting) {
+        // upstream connect advanced by "W5500::poll" - the other rules are serviced meanwhile
+        switch (target_eth.openState(state.target_socket)) {
+            case W5500::Open_Established:
+                state.connecting = false;
+                state.connected = true;
+                relay.reset();
+                break;
+            case W5500::Open_Closing:
+            case W5500::Open_Init:
+            case W5500::Open_Connecting:
+                state.active = false;
+                return;
+            default:
+                // target not reachable -> drop the client
+                state.connecting = false;
+                listen_eth.socketAbort(state.listen_socket);
+                openListener(rule_index);
+                state.active = false;
+                return;
+        }
+    }
+
+    if (!state.connected) {
+        switch (listen_eth.tcpState(state.listen_socket)) {
+            case W5500::TCP_Established:
+            case W5500::TCP_PeerClosed:
+                // client connected -> connect upstream (lazy, without waiting)
+                state.connecting = target_eth.socketOpenAsync(state.target_socket, W5500::TCP_Client);
+                if (!state.connecting) {
+                    listen_eth.socketAbort(state.listen_socket);
+                    openListener(rule_index);
+                } else if (rule.keep_alive != 0) {
+                    target_eth.setKeepAlive(state.target_socket, rule.keep_alive);
+                }
+                break;
+            case W5500::TCP_Closed:
+                openListener(rule_index);
+                break;
+            default:
+                // listening (or connection in progress)
+                break;
+        }
+        if (!state.connected) {
+            state.active = false;
+            return;
+        }
+    }
+
+    state.active = relay.poll() > 0;
+    if (relay.finished()) {
+        // both directions closed -> serve the next client
+        listen_eth.socketClose(state.listen_socket);
+        target_eth.socketClose(state.target_socket);
+        state.connected = false;
+        state.active = false;
+        openListener(rule_index);
+    }
+}
+
+// UDP: client datagrams to the target, replies to the client of the last datagram
+void ForwardService::pollUdp(uint8_t rule_index, bool check) {
+    const ForwardRule &rule = rules[rule_index];
+    RuleState &state = states[rule_index];
+    W5500 &listen_eth = *chips[rule.listen_chip];
+    W5500 &target_eth = *chips[rule.target_chip];
+    if (check) {
+        listen_eth.socketKeepOpen(state.listen_socket, W5500::UDP);
+        target_eth.socketKeepOpen(state.target_socket, W5500::UDP);
+    }
+
+    uint8_t forwarded = 0;
+    for (uint8_t n = 0; n < Batch_MAX; n++) {
+        if (listen_eth.receiveAvailable(state.listen_socket) == 0) {
+            break;
+        }
+        W5500::DatagramInfo info = {};
+        const uint16_t len = listen_eth.receiveDatagram(state.listen_socket, buffer, buffer_len, &info);
+        memcpy(state.client_ip, info.source_ip, sizeof(W5500::IP_t));
+        state.client_port = info.source_port;
+        if (!info.truncated) {
+            target_eth.send(state.target_socket, buffer, len);
+        }
+        forwarded++;
+    }
+    for (uint8_t n = 0; n < Batch_MAX; n++) {
+        if (target_eth.receiveAvailable(state.target_socket) == 0) {
+            break;
+        }
+        const uint16_t len = target_eth.receiveDatagram(state.target_socket, buffer, buffer_len);
+        if (state.client_port != 0) {
+            listen_eth.sendTo(state.listen_socket, state.client_ip, state.client_port, buffer, len);
+        }
+        forwarded++;
+    }
+    state.active = forwarded > 0;
+}
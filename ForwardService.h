@@ -0,0 +1,152 @@
+#ifndef FORWARD_SERVICE_H
+#define FORWARD_SERVICE_H
+
+#include <stddef.h>
+#include "W5500.h"
+#include "TcpRelay.h"
+
+
+/**
+ * @brief Port-forwarding rule (for a constexpr rule table, see `ForwardService`)
+ *
+ * Each rule uses two sockets: a listening socket (listen chip & port) and an upstream socket (target chip),
+ * both with the given RX- & TX-buffer size.
+ * TCP: the upstream connection to the target is opened only when a client connected to the listening socket.
+ * UDP: datagrams are forwarded to the target, replies are returned to the client of the last datagram.
+ */
+struct ForwardRule {
+    enum Protocol : uint8_t {
+        TCP,
+        UDP,
+    };
+    Protocol protocol;
+    uint8_t listen_chip;            // index of the chip in the service
+    W5500::Port_t listen_port;
+    uint8_t target_chip;            // index of the chip in the service
+    uint8_t target_ip[4];
+    W5500::Port_t target_port;
+    W5500::Port_t source_port;      // local port of the upstream socket
+    uint8_t buffer_kB;              // RX- & TX-buffer size of both sockets (1, 2, 4, 8 or 16; 0 = default of 2 kB)
+    uint16_t keep_alive = 0;        // TCP: keep-alive interval of both sockets in seconds (0 = disabled), see `W5500::setKeepAlive`
+};
+
+
+/**
+ * @brief Port-forwarding service for a table of rules
+ *
+ * Allocates two sockets per rule, keeps the listeners open, connects upstream on demand and relays the data
+ * ("TcpRelay" for TCP rules). The common socket interrupt register of each chip is read once per "poll",
+ * only rules with socket events (or data still to relay) are serviced.
+ *
+ * The rule table can be checked at compile time:
+ * @code
+ * constexpr ForwardRule rules[] = {
+ *     {ForwardRule::TCP, 0, 22, 1, {192, 168, 177, 10}, 22, 5051, 2},
+ * };
+ * static_assert(ForwardService::validRules(rules, 2), "invalid forwarding rules");
+ * @endcode
+ */
+class ForwardService {
+public:
+    //=============================
+    // Constants
+    static constexpr uint8_t Rule_MAX = 16;
+    static constexpr uint8_t Chip_MAX = 8;
+    static constexpr uint8_t Buffer_Budget_kB = 16;     // RX- & TX-memory of a W5500 each
+    static constexpr uint8_t Default_Buffer_kB = 2;
+    static constexpr uint16_t Check_Interval_ms = 1000; // status check of all listeners (e.g. after a link loss)
+    static constexpr uint8_t Batch_MAX = 8;             // UDP datagrams per direction, rule & call of `poll`
+
+    //=============================
+    // Compile-time Validation
+
+    /**
+     * @brief Check a rule table against the socket count & buffer memory of each chip
+     * @param rules rule table
+     * @param chip_count number of chips of the service
+     * @return true if valid (at most Rule_MAX rules & chip indices in range, buffer sizes of 0-16 kB as power of 2,
+     * at most 8 sockets & 16 kB RX- & TX-buffer per chip)
+     * Only the rule sockets are counted: "begin" sets the buffers of the free sockets of these chips to 0 kB.
+     * Sockets allocated before "begin" (e.g. reserved by the application) keep their buffers & must fit as well.
+     */
+    template<size_t N>
+    static constexpr bool validRules(const ForwardRule (&rules)[N], uint8_t chip_count) {
+        if ((N > Rule_MAX) || (chip_count > Chip_MAX)) {
+            return false;
+        }
+        for (size_t i = 0; i < N; i++) {
+            const ForwardRule &rule = rules[i];
+            const uint8_t size = rule.buffer_kB;
+            if ((rule.listen_chip >= chip_count) || (rule.target_chip >= chip_count) || (size > 16) || ((size & (size - 1)) != 0)) {
+                return false;
+            }
+        }
+        for (uint8_t chip = 0; chip < chip_count; chip++) {
+            uint8_t sockets = 0;
+            uint16_t buffer_kB = 0;
+            for (size_t i = 0; i < N; i++) {
+                const uint8_t uses = (rules[i].listen_chip == chip) + (rules[i].target_chip == chip);
+                sockets += uses;
+                buffer_kB += uses * ((rules[i].buffer_kB == 0) ? Default_Buffer_kB : rules[i].buffer_kB);
+            }
+            if ((sockets > W5500::Socket_MAX) || (buffer_kB > Buffer_Budget_kB)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //=============================
+    // Constructor
+
+    ForwardService(W5500 *chips[], uint8_t chip_count, const ForwardRule rules[], uint8_t rule_count, uint8_t *buffer, uint16_t buffer_len);
+
+    //=============================
+    // Functions
+
+    bool begin();
+    void poll();
+
+    bool connected(uint8_t rule_index) const;
+    const TcpRelay *relay(uint8_t rule_index) const;
+
+private:
+    //=============================
+    // Type Definitions
+
+    struct RuleState {
+        uint8_t listen_socket;
+        uint8_t target_socket;
+        bool connecting;            // TCP: upstream connect in progress (client waiting)
+        bool connected;             // TCP: upstream connected & relaying
+        bool active;                // data was relayed in the last poll (poll again without events)
+        W5500::IP_t client_ip;      // UDP: client of the last datagram (destination of replies)
+        W5500::Port_t client_port;
+    };
+
+    //=============================
+    // Variables
+
+    W5500 **chips;
+    const uint8_t chip_count;
+    const ForwardRule *rules;
+    const uint8_t rule_count;
+    uint8_t *buffer;
+    const uint16_t buffer_len;
+
+    RuleState states[Rule_MAX] = {};
+    // TCP relays, constructed in "begin" (no heap)
+    alignas(TcpRelay) uint8_t relay_storage[Rule_MAX][sizeof(TcpRelay)];
+    uint8_t rules_started = 0;     // rules configured by "begin"
+    uint32_t last_check = 0;
+
+    //=============================
+    // Functions
+
+    TcpRelay &tcpRelay(uint8_t rule_index);
+    void openListener(uint8_t rule_index);
+    void pollTcp(uint8_t rule_index);
+    void pollUdp(uint8_t rule_index, bool check);
+};
+
+#endif // FORWARD_SERVICE_H
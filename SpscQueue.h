@@ -0,0 +1,83 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+
+/**
+ * @brief Lock-free single-producer / single-consumer queue
+ * 
+ * Hands data between two tasks / threads (e.g. the workers of two SPI buses) without locks.
+ * Exactly one task may push and exactly one task may pop. Items are copied, no heap is used.
+ * Use `uint8_t` items as byte stream (e.g. for relaying TCP data between chips on different buses).
+ * 
+ * @tparam T Item type (copyable)
+ * @tparam Capacity Number of items, must be a power of 2 (max. 32768)
+ */
+template <typename T, uint16_t Capacity>
+class SpscQueue {
+    static_assert( (Capacity > 0) && ( (Capacity & (Capacity - 1)) == 0) && (Capacity <= 32768), "Capacity must be a power of 2 (max. 32768)");
+
+public:
+    //=============================
+    // Producer
+
+    // free space for pushing
+    uint16_t space() const {
+        return Capacity - static_cast<uint16_t>(tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire));
+    }
+
+    // push a single item, false if the queue is full
+    bool push(const T &item) {
+        return push(&item, 1) == 1;
+    }
+
+    // push up to count items, returns the number of items pushed
+    uint16_t push(const T *items, uint16_t count) {
+        const uint16_t t = tail.load(std::memory_order_relaxed);
+        const uint16_t free = space();
+        const uint16_t n = count < free ? count : free;
+        for (uint16_t i = 0; i < n; i++) {
+            buffer[static_cast<uint16_t>(t + i) & (Capacity - 1)] = items[i];
+        }
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    //=============================
+    // Consumer
+
+    // number of items available for popping
+    uint16_t size() const {
+        return static_cast<uint16_t>(tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed));
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // pop a single item, false if the queue is empty
+    bool pop(T &item) {
+        return pop(&item, 1) == 1;
+    }
+
+    // pop up to count items, returns the number of items popped
+    uint16_t pop(T *items, uint16_t count) {
+        const uint16_t h = head.load(std::memory_order_relaxed);
+        const uint16_t available = size();
+        const uint16_t n = count < available ? count : available;
+        for (uint16_t i = 0; i < n; i++) {
+            items[i] = buffer[static_cast<uint16_t>(h + i) & (Capacity - 1)];
+        }
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    T buffer[Capacity];
+    std::atomic<uint16_t> head{0};  // next item to pop (written by consumer only)
+    std::atomic<uint16_t> tail{0};  // next free slot (written by producer only)
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,98 @@
+#include "TcpRelay.h"
+
+/**
+ * @brief Constructor
+ * @param eth_a W5500 of endpoint A
+ * @param socket_a socket number of endpoint A
+ * @param eth_b W5500 of endpoint B
+ * @param socket_b socket number of endpoint B
+ * @param buffer buffer for the copy (shared by both directions), split into two chunks
+ * @param buffer_len size of the buffer
+ */
+TcpRelay::TcpRelay(W5500 &eth_a, uint8_t socket_a, W5500 &eth_b, uint8_t socket_b, uint8_t *buffer, uint16_t buffer_len)
+    : endpoints{{eth_a, socket_a}, {eth_b, socket_b}}, buffers{buffer, buffer + buffer_len / 2}, chunk_len(buffer_len / 2) {
+    reset();
+}
+
+/**
+ * @brief Relay the received data in each direction, as far as the other side can take it (call regularly)
+ * @return number of bytes relayed (both directions)
+ */
+uint32_t TcpRelay::poll() {
+    uint32_t relayed = relay(endpoints[0], endpoints[1], flows[A_to_B]);
+    relayed += relay(endpoints[1], endpoints[0], flows[B_to_A]);
+
+    const uint32_t now = endpoints[0].eth.timeMs();
+    updateRate(flows[A_to_B], now);
+    updateRate(flows[B_to_A], now);
+    return relayed;
+}
+
+// both directions are closed - the sockets can be closed
+bool TcpRelay::finished() const {
+    return flows[A_to_B].closed && flows[B_to_A].closed;
+}
+
+// the direction is closed (FIN forwarded or sink closed)
+bool TcpRelay::finished(Direction direction) const {
+    return flows[direction].closed;
+}
+
+/**
+ * @brief Reset the state & throughput (e.g. for relaying a new connection on the same sockets)
+ */
+void TcpRelay::reset() {
+    const uint32_t now = endpoints[0].eth.timeMs();
+    for (Flow &flow : flows) {
+        flow = Flow{};
+        flow.rate_start = now;
+    }
+}
+
+// throughput of one direction
+const TcpRelay::Throughput &TcpRelay::throughput(Direction direction) const {
+    return flows[direction].throughput;
+}
+
+
+//=======================================================
+// Private Functions
+//=======================================================
+
+// relay received data from source to sink, forward a half-close
+uint16_t TcpRelay::relay(Endpoint &source, Endpoint &sink, Flow &flow) {
+    if (flow.closed) {
+        return 0;
+    }
+    if (source.eth.receiveAvailable(source.socket_n) == 0) {
+        // source closed & all data relayed -> forward the half-close
+        const W5500::TcpState source_state = source.eth.tcpState(source.socket_n);
+        if ((source_state == W5500::TCP_PeerClosed) || (source_state == W5500::TCP_Closed)) {
+            sink.eth.socketShutdown(sink.socket_n);
+            flow.closed = true;
+        }
+        return 0;
+    }
+    const uint16_t len = source.eth.pipeTo(source.socket_n, sink.eth, sink.socket_n, buffers, chunk_len);
+    if (len == 0) {
+        // sink closed -> the data can't be delivered anymore
+        const W5500::TcpState sink_state = sink.eth.tcpState(sink.socket_n);
+        if ((sink_state == W5500::TCP_Closed) || (sink_state == W5500::TCP_LocalClosed)) {
+            flow.closed = true;
+        }
+        return 0;
+    }
+    flow.throughput.bytes += len;
+    flow.rate_bytes += len;
+    return len;
+}
+
+// update bytes_per_second after each measurement interval
+void TcpRelay::updateRate(Flow &flow, uint32_t now) {
+    const uint32_t elapsed = now - flow.rate_start;
+    if (elapsed >= Rate_Interval_ms) {
+        flow.throughput.bytes_per_second = static_cast<uint32_t>((static_cast<uint64_t>(flow.rate_bytes) * 1000) / elapsed);
+        flow.rate_bytes = 0;
+        flow.rate_start = now;
+    }
+}
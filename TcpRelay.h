@@ -0,0 +1,81 @@
+#ifndef TCP_RELAY_H
+#define TCP_RELAY_H
+
+#include "W5500.h"
+
+
+/**
+ * @brief Bidirectional relay between two TCP sockets (same or different W5500)
+ *
+ * Data is only read from the source as far as the sink can take it (free space in the TX buffer),
+ * so nothing is dropped or kept on the host: the data is copied with "W5500::pipeTo", which acknowledges
+ * the source only after the sink accepted the data. The buffer is split into two chunks (double buffering).
+ * Half-close is forwarded: when a source closed its direction (FIN) & all its data is relayed,
+ * the sink is shut down ("W5500::socketShutdown"), the other direction continues until it closes as well.
+ * The sockets have to be connected (opened) & closed by the application.
+ */
+class TcpRelay {
+public:
+    //=============================
+    // Type Definitions
+
+    enum Direction{
+        A_to_B,
+        B_to_A,
+    };
+    // Throughput of one direction
+    struct Throughput {
+        uint32_t bytes;             // relayed bytes (since start or "reset")
+        uint32_t bytes_per_second;  // average of the last measurement interval
+    };
+
+    //-----------------------------
+    // Constants
+    static constexpr uint16_t Rate_Interval_ms = 1000;
+
+    //=============================
+    // Constructor
+
+    TcpRelay(W5500 &eth_a, uint8_t socket_a, W5500 &eth_b, uint8_t socket_b, uint8_t *buffer, uint16_t buffer_len);
+
+    //=============================
+    // Functions
+
+    uint32_t poll();
+    bool finished() const;
+    bool finished(Direction direction) const;
+    void reset();
+
+    const Throughput &throughput(Direction direction) const;
+
+private:
+    //=============================
+    // Type Definitions
+
+    struct Endpoint {
+        W5500 &eth;
+        uint8_t socket_n;
+    };
+    struct Flow {
+        bool closed = false;            // FIN forwarded (or sink closed)
+        Throughput throughput = {};
+        uint32_t rate_bytes = 0;        // bytes of the current measurement interval
+        uint32_t rate_start = 0;
+    };
+
+    //=============================
+    // Variables
+
+    Endpoint endpoints[2];
+    uint8_t *buffers[2];
+    const uint16_t chunk_len;
+    Flow flows[2];
+
+    //=============================
+    // Functions
+
+    uint16_t relay(Endpoint &source, Endpoint &sink, Flow &flow);
+    void updateRate(Flow &flow, uint32_t now);
+};
+
+#endif // TCP_RELAY_H
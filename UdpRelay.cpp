@@ -0,0 +1,188 @@
+#include "UdpRelay.h"
+
+#include <string.h>
+
+/**
+ * @brief Constructor
+ * @param eth W5500 of the ingress socket
+ * @param socket_n ingress socket (UDP, opened by the application)
+ * @param pool socket pool providing the egress sockets
+ * @param owner owner ID of the egress sockets in the socket pool (non-zero)
+ * @param egress_chip index of the chip for the egress sockets (in the socket pool)
+ * @param target_ip IP address of the target
+ * @param target_port port of the target
+ * @param egress_port_base source port of the egress sockets (plus session number)
+ * @param buffer buffer for the datagrams (at least the largest datagram relayed)
+ * @param buffer_len size of the buffer
+ * @param idle_timeout a session without datagrams for this time (seconds) is closed
+ */
+UdpRelay::UdpRelay(W5500 &eth, uint8_t socket_n, W5500SocketPool &pool, uint8_t owner, uint8_t egress_chip,
+    const W5500::IP_t target_ip, W5500::Port_t target_port, W5500::Port_t egress_port_base,
+    uint8_t *buffer, uint16_t buffer_len, float idle_timeout)
+    : eth(eth), socket_n(socket_n), pool(pool), owner(owner), egress_chip(egress_chip), target_port(target_port),
+      egress_port_base(egress_port_base), buffer(buffer), buffer_len(buffer_len), idle_timeout_ms(idle_timeout * 1000) {
+    memcpy(this->target_ip, target_ip, sizeof(W5500::IP_t));
+}
+
+/**
+ * @brief Forward datagrams in both directions & close idle sessions (call regularly)
+ * @return number of datagrams forwarded
+ */
+uint16_t UdpRelay::poll() {
+    const uint32_t now = eth.timeMs();
+    uint16_t forwarded = forwardToTarget(now);
+    forwarded += forwardToClients(now);
+    expireSessions(now);
+    return forwarded;
+}
+
+/**
+ * @brief Close all sessions (the egress sockets are returned to the socket pool)
+ */
+void UdpRelay::closeAll() {
+    for (Session &session : session_table) {
+        if (session.used) {
+            closeSession(session);
+        }
+    }
+}
+
+// number of open sessions
+uint8_t UdpRelay::sessions() const {
+    uint8_t count = 0;
+    for (const Session &session : session_table) {
+        if (session.used) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// relay statistics
+const UdpRelay::Stats &UdpRelay::stats() const {
+    return relay_stats;
+}
+
+
+//=======================================================
+// Private Functions
+//=======================================================
+
+// client -> target: ingress socket to the egress socket of the session
+uint16_t UdpRelay::forwardToTarget(uint32_t now) {
+    uint16_t forwarded = 0;
+    for (uint8_t n = 0; n < Batch_MAX; n++) {
+        if (eth.receiveAvailable(socket_n) == 0) {
+            break;
+        }
+        W5500::DatagramInfo info = {};
+        const uint16_t len = eth.receiveDatagram(socket_n, buffer, buffer_len, &info);
+        Session *session = findSession(info.source_ip, info.source_port);
+        if (session == nullptr) {
+            session = openSession(info.source_ip, info.source_port);
+        }
+        if ((session == nullptr) || info.truncated) {
+            relay_stats.dropped++;
+            continue;
+        }
+        session->last_active = now;
+        if (session->egress.chip->send(session->egress.socket_n, buffer, len) == len) {
+            relay_stats.to_target++;
+            forwarded++;
+        } else {
+            relay_stats.dropped++;
+        }
+    }
+    return forwarded;
+}
+
+// target -> clients: datagrams of all egress sockets, sent in a batch on the ingress socket
+uint16_t UdpRelay::forwardToClients(uint32_t now) {
+    W5500::Datagram batch[Batch_MAX];
+    uint16_t count = 0;
+    uint16_t used = 0;
+    for (Session &session : session_table) {
+        if (!session.used) {
+            continue;
+        }
+        W5500 &egress = *session.egress.chip;
+        const uint8_t egress_socket = session.egress.socket_n;
+        while ((count < Batch_MAX) && (egress.receiveAvailable(egress_socket) > 0)) {
+            // datagram size from the Packet-Info header - must fit into the remaining buffer
+            uint8_t udp_header[8];
+            if (egress.peek(egress_socket, udp_header, sizeof(udp_header)) < sizeof(udp_header)) {
+                break;
+            }
+            const uint16_t size = (udp_header[6] << 8) | udp_header[7];
+            if (size > buffer_len) {
+                egress.receiveDatagram(egress_socket, nullptr, 0);
+                relay_stats.dropped++;
+                continue;
+            }
+            if (size > buffer_len - used) {
+                break; // sent with the next batch
+            }
+            const uint16_t len = egress.receiveDatagram(egress_socket, &buffer[used], size);
+            W5500::Datagram &datagram = batch[count++];
+            memcpy(datagram.dest_ip, session.client_ip, sizeof(W5500::IP_t));
+            datagram.dest_port = session.client_port;
+            datagram.data = &buffer[used];
+            datagram.len = len;
+            used += len;
+            session.last_active = now;
+        }
+    }
+    const uint16_t sent = (count > 0) ? eth.sendDatagrams(socket_n, batch, count) : 0;
+    relay_stats.to_clients += sent;
+    relay_stats.dropped += count - sent;
+    return sent;
+}
+
+// close sessions without datagrams for the idle timeout
+void UdpRelay::expireSessions(uint32_t now) {
+    for (Session &session : session_table) {
+        if (session.used && ((now - session.last_active) >= idle_timeout_ms)) {
+            closeSession(session);
+        }
+    }
+}
+
+// session of a client, nullptr if none
+UdpRelay::Session *UdpRelay::findSession(const W5500::IP_t client_ip, W5500::Port_t client_port) {
+    for (Session &session : session_table) {
+        if (session.used && (session.client_port == client_port) && (memcmp(session.client_ip, client_ip, sizeof(W5500::IP_t)) == 0)) {
+            return &session;
+        }
+    }
+    return nullptr;
+}
+
+// new session with an egress socket (opened in UDP mode to the target), nullptr if no session or socket is free
+UdpRelay::Session *UdpRelay::openSession(const W5500::IP_t client_ip, W5500::Port_t client_port) {
+    for (uint8_t i = 0; i < Session_MAX; i++) {
+        Session &session = session_table[i];
+        if (session.used) {
+            continue;
+        }
+        if (!pool.acquireOn(egress_chip, owner, session.egress)) {
+            return nullptr;
+        }
+        W5500 &egress = *session.egress.chip;
+        egress.setSocketSource(session.egress.socket_n, egress_port_base + i);
+        egress.setSocketDest(session.egress.socket_n, target_ip, target_port);
+        if (!egress.socketOpen(session.egress.socket_n, W5500::UDP)) {
+            pool.release(session.egress, owner, false);
+            return nullptr;
+        }
+        session.used = true;
+        memcpy(session.client_ip, client_ip, sizeof(W5500::IP_t));
+        session.client_port = client_port;
+        return &session;
+    }
+    return nullptr;
+}
+
+void UdpRelay::closeSession(Session &session) {
+    pool.release(session.egress, owner, false);
+    session.used = false;
+}
@@ -0,0 +1,91 @@
+#ifndef UDP_RELAY_H
+#define UDP_RELAY_H
+
+#include "W5500SocketPool.h"
+
+
+/**
+ * @brief UDP relay with a session per client
+ *
+ * Datagrams received on the ingress socket (opened by the application in UDP mode) are forwarded to a fixed target.
+ * Each client (source IP & port) gets its own session with an egress socket from a "W5500SocketPool",
+ * so the replies of the target can be returned to the right client ("W5500::sendDatagrams", batched).
+ * The destination of the ingress socket is never rewritten for receiving. Idle sessions are closed after a timeout.
+ */
+class UdpRelay {
+public:
+    //=============================
+    // Type Definitions
+
+    struct Stats {
+        uint32_t to_target;     // datagrams forwarded from clients to the target
+        uint32_t to_clients;    // datagrams forwarded from the target to the clients
+        uint32_t dropped;       // datagrams dropped (no free session/socket, too large for the buffer)
+    };
+
+    //-----------------------------
+    // Constants
+    static constexpr uint8_t Session_MAX = 16;
+    static constexpr uint8_t Batch_MAX = 8;     // datagrams per direction & call of `poll`
+
+    //=============================
+    // Constructor
+
+    UdpRelay(W5500 &eth, uint8_t socket_n, W5500SocketPool &pool, uint8_t owner, uint8_t egress_chip,
+        const W5500::IP_t target_ip, W5500::Port_t target_port, W5500::Port_t egress_port_base,
+        uint8_t *buffer, uint16_t buffer_len, float idle_timeout = 30.0);
+
+    //=============================
+    // Functions
+
+    uint16_t poll();
+    void closeAll();
+
+    uint8_t sessions() const;
+    const Stats &stats() const;
+
+private:
+    //=============================
+    // Type Definitions
+
+    struct Session {
+        bool used;
+        W5500::IP_t client_ip;
+        W5500::Port_t client_port;
+        W5500SocketPool::Handle egress;
+        uint32_t last_active;
+    };
+
+    //=============================
+    // Variables
+
+    // Ingress socket (clients)
+    W5500 &eth;
+    const uint8_t socket_n;
+    // Egress sockets (target)
+    W5500SocketPool &pool;
+    const uint8_t owner;
+    const uint8_t egress_chip;
+    W5500::IP_t target_ip;
+    const W5500::Port_t target_port;
+    const W5500::Port_t egress_port_base;
+
+    uint8_t *buffer;
+    const uint16_t buffer_len;
+    const uint32_t idle_timeout_ms;
+
+    Session session_table[Session_MAX] = {};
+    Stats relay_stats = {};
+
+    //=============================
+    // Functions
+
+    uint16_t forwardToTarget(uint32_t now);
+    uint16_t forwardToClients(uint32_t now);
+    void expireSessions(uint32_t now);
+    Session *findSession(const W5500::IP_t client_ip, W5500::Port_t client_port);
+    Session *openSession(const W5500::IP_t client_ip, W5500::Port_t client_port);
+    void closeSession(Session &session);
+};
+
+#endif // UDP_RELAY_H
@@ -12,18 +12,42 @@ W5500::W5500(SpiFrame &spiFrame) : spiFrame(spiFrame) {}
  * @brief Initialize the SPI interface & the W5500
  */
 void W5500::init() {
-    spiFrame.init();
-
-    // Reset the W5500
-    wrCommonReg(CommonOffsetAddr::common_mode_register, 0x80);
-    spiFrame.sleep(0.001);
-    wrCommonReg(CommonOffsetAddr::common_mode_register, common_mode_register_value);
+    for (uint8_t step = 0; step < Init_Steps; step++) {
+        spiFrame.sleep(initStep(step));
+    }
+}
 
-    // Reset & Configure PHY (auto-negotiation)
-    wrCommonReg(CommonOffsetAddr::phy_config, phy_config_register_value & 0x78);
-    spiFrame.sleep(0.001);
-    wrCommonReg(CommonOffsetAddr::phy_config, phy_config_register_value);
-    spiFrame.sleep(0.001);
+/**
+ * @brief Perform a single step of the initialization (see "init")
+ * @param step Step number (0 to Init_Steps-1)
+ * @return time in seconds to wait before the next step
+ * Allows initializing multiple W5500 in parallel, waiting only once per step (see "W5500Group::initAll").
+ */
+float W5500::initStep(uint8_t step) {
+    switch (step) {
+        case 0:
+            spiFrame.init();
+            // Reset the W5500 (& host-side state of all sockets)
+            send_pending = 0;
+            timeout_events = 0;
+            keep_alive = 0;
+            interface_network.valid = false;
+            for (uint8_t socket_n = 0; socket_n < Socket_MAX; socket_n++) {
+                resetSocketState(socket_n);
+            }
+            wrCommonReg(CommonOffsetAddr::common_mode_register, 0x80);
+            return 0.001;
+        case 1:
+            wrCommonReg(CommonOffsetAddr::common_mode_register, common_mode_register_value);
+            // Reset & Configure PHY (auto-negotiation)
+            wrCommonReg(CommonOffsetAddr::phy_config, phy_config_register_value & 0x78);
+            return 0.001;
+        case 2:
+            wrCommonReg(CommonOffsetAddr::phy_config, phy_config_register_value);
+            return 0.001;
+        default:
+            return 0;
+    }
 }
 
 //=======================================================
@@ -36,7 +60,7 @@ void W5500::init() {
  * @param mode Mode of the socket
  * @return true if the socket was opened successfully, false if failed (e.g. the PHY link is down)
  * In case of TCP_Client, only return true if the TCP connection to the server was successful.
- * There are timeouts for each step, the function will return eventually.
+ * There are timeouts for each step (see "setSocketTimeout", Timeout_Open), the function will return eventually.
  */
 bool W5500::socketOpen(uint8_t socket_n, SocketMode mode) {
     if (! phyLinkUp()) {
@@ -45,22 +69,18 @@ bool W5500::socketOpen(uint8_t socket_n, SocketMode mode) {
     }
 
     // variables depending on the mode
-    uint8_t mode_value = socket_mode_register_default;
     SocketCommandReg second_command;
     SocketStatusReg expected_state;
     switch (mode) {
         case TCP_Server:
-            mode_value |= 0x01;
             second_command = LISTEN;
             expected_state = SOCK_LISTEN;
             break;
         case TCP_Client:
-            mode_value |= 0x01;
             second_command = CONNECT;
             expected_state = SOCK_ESTABLISHED;
             break;
         case UDP:
-            mode_value |= 0x02;
             break;
     }
 
@@ -68,13 +88,13 @@ bool W5500::socketOpen(uint8_t socket_n, SocketMode mode) {
     socketClose(socket_n);
 
     // set the mode & open (initialise) the socket
-    wrSocketReg(socket_n, SocketOffsetAddr::socket_mode_register, mode_value);
+    wrSocketReg(socket_n, SocketOffsetAddr::socket_mode_register, socketModeValue(mode));
     socketCommand(socket_n, OPEN);
     
     switch(mode) {
         // UDP Connection
         case UDP:
-            if (waitSocketStatus(socket_n, SOCK_UDP, socket_timeout)) {
+            if (waitSocketStatus(socket_n, SOCK_UDP, getSocketTimeout(socket_n, Timeout_Open))) {
                 return true;  // success
             }
             break;
@@ -83,10 +103,10 @@ bool W5500::socketOpen(uint8_t socket_n, SocketMode mode) {
         case TCP_Server:
         case TCP_Client:
             // TCP Connection
-            if(waitSocketStatus(socket_n, SOCK_INIT, socket_timeout)) {
+            if(waitSocketStatus(socket_n, SOCK_INIT, getSocketTimeout(socket_n, Timeout_Open))) {
                 // socket is now in SOCK_INIT state
                 socketCommand(socket_n, second_command);
-                if(waitSocketStatus(socket_n, expected_state, socket_timeout)) {
+                if(waitSocketStatus(socket_n, expected_state, getSocketTimeout(socket_n, Timeout_Open))) {
                     return true;  // success
                 }
             }
@@ -97,27 +117,134 @@ bool W5500::socketOpen(uint8_t socket_n, SocketMode mode) {
     return false; // failure
 }
 
+/**
+ * @brief Start opening a socket without waiting - IP & Port configuration is required before
+ * @param socket_n Socket number
+ * @param mode Mode of the socket
+ * @return true if the open was started, false if the PHY link is down
+ * The open is advanced by "poll" (one status read per call): closing the previous connection,
+ * OPEN, then LISTEN / CONNECT for TCP. Each step has the same timeout as "socketOpen" (Timeout_Close for the disconnect).
+ * Check the progress with "openState". "socketClose" & "socketAbort" cancel the open.
+ */
+bool W5500::socketOpenAsync(uint8_t socket_n, SocketMode mode) {
+    SocketState &state = socket_state[socket_n];
+    if (! phyLinkUp()) {
+        state.open_state = Open_Failed;
+        return false;
+    }
+    resetSocketState(socket_n);
+    state.open_mode = mode;
+
+    switch(socketStatusReg(socket_n)) {
+        case SOCK_CLOSED:
+            break;
+        case SOCK_ESTABLISHED:
+        case SOCK_CLOSE_WAIT:
+            // TCP disconnect first - "poll" opens once the socket is closed
+            socketCommand(socket_n, DISCONNECT);
+            state.open_state = Open_Closing;
+            state.open_deadline = socketDeadline(socket_n, Timeout_Close);
+            return true;
+        default:
+            socketCommand(socket_n, CLOSE);
+            break;
+    }
+    openCommand(socket_n);
+    return true;
+}
+
+/**
+ * @brief Progress of a non-blocking open (see "socketOpenAsync")
+ * @param socket_n Socket number
+ * @return Open_Established once opened, Open_Failed after a timeout - no SPI access
+ * Only a local close (e.g. "socketClose") resets it to Open_Idle. If the peer closes the connection, it stays
+ * Open_Established - check "tcpState" for the connection itself.
+ */
+W5500::OpenState W5500::openState(uint8_t socket_n) const {
+    return socket_state[socket_n].open_state;
+}
+
 /**
  * @brief Cloase a socket
  * @param socket_n Socket number
- * Try to use TCP-disconnect for TCP connection
+ * Try to use TCP-disconnect for TCP connection (waits up to the Timeout_Close of the socket)
+ * Coalesced data is sent before the disconnect (see "flush").
  */
 void W5500::socketClose(uint8_t socket_n) {
-    switch(socketStatusReg(socket_n)) {
+    const SocketStatusReg status = closeStart(socket_n);
+    switch(status) {
         case SOCK_CLOSED:
             return;
         case SOCK_ESTABLISHED:
         case SOCK_CLOSE_WAIT:
             //TCP connection
             socketCommand(socket_n, DISCONNECT);
-            if (waitSocketStatus(socket_n, SOCK_CLOSED, socket_timeout)) {
+            if (waitSocketStatus(socket_n, SOCK_CLOSED, getSocketTimeout(socket_n, Timeout_Close))) {
                 // socket is closed now
                 return;
             }
+            break;
+        default:
+            break;
     }
     socketCommand(socket_n, CLOSE);
 }
 
+/**
+ * @brief Close a socket immediately, without TCP disconnect (e.g. when the PHY link is down)
+ * @param socket_n Socket number
+ */
+void W5500::socketAbort(uint8_t socket_n) {
+    resetSocketState(socket_n);
+    socketCommand(socket_n, CLOSE);
+}
+
+/**
+ * @brief Close a socket without waiting - TCP disconnect in the background
+ * @param socket_n Socket number
+ * Issues DISCONNECT for a TCP connection & returns. "poll" checks for the closed socket & escalates to CLOSE
+ * after the Timeout_Close of the socket (see "setSocketTimeout"). Until then the socket is not free for allocation (see "socketClosing", "allocateSocket").
+ * Calling it again while the disconnect is in progress has no effect.
+ * Coalesced data is sent before the disconnect (see "flush" - only waits if the previous SEND is still in progress).
+ */
+void W5500::socketCloseAsync(uint8_t socket_n) {
+    if (socketClosing(socket_n)) {
+        // already disconnecting (e.g. called on every loop)
+        return;
+    }
+    const SocketStatusReg status = closeStart(socket_n);
+    switch(status) {
+        case SOCK_CLOSED:
+            return;
+        case SOCK_ESTABLISHED:
+        case SOCK_CLOSE_WAIT:
+            //TCP connection
+            socketCommand(socket_n, DISCONNECT);
+            close_pending |= (1 << socket_n);
+            socket_state[socket_n].close_deadline = socketDeadline(socket_n, Timeout_Close);
+            return;
+        default:
+            break;
+    }
+    socketCommand(socket_n, CLOSE);
+}
+
+// common start of "socketClose" & "socketCloseAsync": send coalesced data of a connection & forget the socket state,
+// returns the status before the close
+W5500::SocketStatusReg W5500::closeStart(uint8_t socket_n) {
+    const SocketStatusReg status = socketStatusReg(socket_n);
+    if ( (status == SOCK_ESTABLISHED) || (status == SOCK_CLOSE_WAIT) ) {
+        flush(socket_n);
+    }
+    resetSocketState(socket_n);
+    return status;
+}
+
+// TCP disconnect of "socketCloseAsync" still in progress (no SPI access)
+bool W5500::socketClosing(uint8_t socket_n) const {
+    return (close_pending & (1 << socket_n)) != 0;
+}
+
 /**
  * @brief Keep a socket open (re-open if socket was closed)
  * @param socket_n Socket number
@@ -196,6 +323,85 @@ bool W5500::socketConnected(uint8_t socket_n) {
     }
 }
 
+/**
+ * @brief Get the detailed TCP state of a socket (without any maintenance, unlike "socketStatus")
+ * @param socket_n Socket number
+ * @return TCP state, TCP_Closed for closed & UDP sockets
+ * Allows handling half-closed connections: data can be received until the peer closes & sent until shutdown.
+ */
+W5500::TcpState W5500::tcpState(uint8_t socket_n) {
+    switch(socketStatusReg(socket_n)) {
+        case SOCK_INIT:
+        case SOCK_LISTEN:
+        case SOCK_SYNSENT:
+        case SOCK_SYNRECV:
+            return TCP_Opening;
+        case SOCK_ESTABLISHED:
+            return TCP_Established;
+        case SOCK_CLOSE_WAIT:
+            return TCP_PeerClosed;
+        case SOCK_FIN_WAIT:
+        case SOCK_CLOSING:
+        case SOCK_TIME_WAIT:
+        case SOCK_LAST_ACK:
+            return TCP_LocalClosed;
+        default:
+            return TCP_Closed;
+    }
+}
+
+/**
+ * @brief Close the sending direction of a TCP connection (send FIN), without waiting
+ * @param socket_n Socket number
+ * Data not yet sent (see "setSendCoalescing") is sent before. Receiving is still possible until the peer closes.
+ */
+void W5500::socketShutdown(uint8_t socket_n) {
+    switch(socketStatusReg(socket_n)) {
+        case SOCK_ESTABLISHED:
+        case SOCK_CLOSE_WAIT:
+            flush(socket_n);
+            socketCommand(socket_n, DISCONNECT);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Set the automatic TCP keep-alive of a socket (Sn_KPALVTR)
+ * @param socket_n Socket number
+ * @param interval Time between keep-alive packets in seconds (rounded up to 5 s steps, max. 1275 s), 0 = disabled
+ * The W5500 sends keep-alive packets on an idle connection (after the first data was exchanged).
+ * A dead peer (no reply after the retransmissions, see "setRetransmission") closes the socket
+ * & is reported as Event_Timeout | Event_KeepAliveTimeout by "socketEvents" - no application heartbeat required.
+ * Set it after opening the socket (e.g. right after "socketOpenAsync") - it is disabled when the socket is opened or closed.
+ */
+void W5500::setKeepAlive(uint8_t socket_n, float interval) {
+    const float steps = (interval + 4.999) / 5;
+    const uint8_t value = (interval <= 0) ? 0 : ( (steps > 0xFF) ? 0xFF : static_cast<uint8_t>(steps) );
+    wrSocketReg(socket_n, SocketOffsetAddr::keep_alive_timer, value);
+    if (value != 0) {
+        keep_alive |= (1 << socket_n);
+    } else {
+        keep_alive &= ~(1 << socket_n);
+    }
+}
+
+/**
+ * @brief Send a single TCP keep-alive packet (SEND_KEEP), e.g. with the automatic keep-alive disabled
+ * @param socket_n Socket number
+ * @return true if sent, false if the connection is not established or a SEND is still in progress
+ * Only valid after the first data was exchanged on the connection. A dead peer is reported like with "setKeepAlive".
+ */
+bool W5500::sendKeepAlive(uint8_t socket_n) {
+    if ( (socketStatusReg(socket_n) != SOCK_ESTABLISHED) || !sendCompleted(socket_n) ) {
+        return false;
+    }
+    socketCommand(socket_n, SEND_KEEP);
+    keep_alive |= (1 << socket_n);
+    return true;
+}
+
 
 //=======================================================
 // Send & Receive data
@@ -205,10 +411,17 @@ bool W5500::socketConnected(uint8_t socket_n) {
  * @brief Get the number of bytes available (in TX Buffer) for sending
  * @param socket_n Socket number
  * @return Number of bytes available for sending, 0 if the socket is not connected
+ * Send coalescing: bytes not yet sent are excluded, expired coalesced data is sent.
+ * A half-closed TCP connection (FIN received) can still send.
  */
 uint16_t W5500::sendAvailable(uint8_t socket_n) {
-    if (socketConnected(socket_n)) {
-        return rdSocketReg16_atomic(socket_n, SocketOffsetAddr::tx_free_size);
+    if (socketSendable(socket_n)) {
+        if (txCoalescingExpired(socket_n)) {
+            flush(socket_n);
+        }
+        SocketState &state = socket_state[socket_n];
+        state.tx_free = rdSocketReg16_atomic(socket_n, SocketOffsetAddr::tx_free_size);
+        return state.tx_free - state.tx_pending;
     } else { // socket is not connected
         return 0;
     }
@@ -218,10 +431,15 @@ uint16_t W5500::sendAvailable(uint8_t socket_n) {
  * @brief Get the number of bytes received (in RX Buffer) for reading
  * @param socket_n Socket number
  * @return Number of bytes available for reading, 0 if the socket is not connected
+ * Deferred RECV acknowledgement: bytes already read are excluded, an expired deferral is acknowledged.
+ * The remaining data of a half-closed TCP connection (FIN received or sent) can still be read.
  */
 uint16_t W5500::receiveAvailable(uint8_t socket_n) {
-    if (socketConnected(socket_n)) {
-        return rdSocketReg16_atomic(socket_n, SocketOffsetAddr::rx_received_size);
+    if (socketReceivable(socket_n)) {
+        if (rxDeferralExpired(socket_n)) {
+            flushReceive(socket_n);
+        }
+        return rdSocketReg16_atomic(socket_n, SocketOffsetAddr::rx_received_size) - socket_state[socket_n].rx_pending;
     } else { // socket is not connected
         return 0;
     }
@@ -233,10 +451,13 @@ uint16_t W5500::receiveAvailable(uint8_t socket_n) {
  * @param data Pointer to the sending data (will be overwritten with unimportant data)
  * @param len length of the data
  * @return actuall number of bytes sent
- * The SEND command will be issued, sending the data to the destination.
+ * The SEND command will be issued, sending the data to the destination (may be coalesced, see "setSendCoalescing").
+ * Blocking: a previous SEND must be completed first - waits up to the Timeout_Send of the socket for its SEND_OK
+ * (see "setSocketTimeout"). Use "sendAll" or check "sendCompleted" before to avoid waiting.
  */
 uint16_t W5500::send(uint8_t socket_n, uint8_t *data, uint16_t len) {
-    len = std::min(len, sendAvailable(socket_n));
+    const uint16_t available = sendAvailable(socket_n);
+    len = std::min(len, available);
     // no space available in buffer
     if (len == 0) {
         return 0;
@@ -244,13 +465,13 @@ uint16_t W5500::send(uint8_t socket_n, uint8_t *data, uint16_t len) {
 
     //=== Write Operation
     // 1. Read starting address
-    const uint16_t write_pointer = rdSocketReg16(socket_n, SocketOffsetAddr::tx_write_pointer);
+    const uint16_t write_pointer = txWritePointer(socket_n);
     // 2. Write data to the buffer
     spiFrame.transfer(SpiFrame::Frame{write_pointer, socket_n, SpiFrame::TxBuffer, SpiFrame::Write}, data, len);
-    // 3. Update the write pointer
-    wrSocketReg16(socket_n, SocketOffsetAddr::tx_write_pointer, write_pointer + len);
-    // 4. Send the data
-    socketCommand(socket_n, SEND);
+    // 3. Update the write pointer & send the data (SEND) - send immediately if the buffer is full
+    if (! txAdvance(socket_n, len, len == available)) {
+        return 0;
+    }
 
     return len;
 }
@@ -262,13 +483,18 @@ uint16_t W5500::send(uint8_t socket_n, uint8_t *data, uint16_t len) {
  * @param len maximum length of the receiving data
  * @param udpMode only applicable for UDP, define how the Packet-Info header should be treated
  * @return actuall number of bytes received
- * The RECV command will be issued, updating the read pointer of W5500.
+ * The RECV command will be issued, updating the read pointer of W5500 (may be deferred, see "setReceiveDeferral").
  * In UDP mode, the W5500 puts 8-byte Packet-Info before the payload data.
  * <https://docs.wiznet.io/Product/iEthernet/W5500/Application/udp>
+ * PayloadOnly & UpdateDestination read one datagram, a remainder not fitting into len is discarded (see "receiveDatagram").
  */
 uint16_t W5500::receive(uint8_t socket_n, uint8_t *data, uint16_t len, UdpHeaderMode udpMode) {
-    uint16_t rec_available = receiveAvailable(socket_n);
-    len = std::min(len, rec_available);
+    //--- UDP-Header information in the first 8 bytes
+    if ( (udpMode != UdpHeaderMode::Raw) && (socketStatus(socket_n) == UDP_Open) ) {
+        return receiveUdp(socket_n, data, len, nullptr, udpMode == UdpHeaderMode::UpdateDestination);
+    }
+
+    len = std::min(len, receiveAvailable(socket_n));
     // nothing to receive
     if (len == 0) {
         return 0;
@@ -276,36 +502,440 @@ uint16_t W5500::receive(uint8_t socket_n, uint8_t *data, uint16_t len, UdpHeader
 
     //=== Read Operation
     // 1. Read starting address
-    uint16_t read_pointer = rdSocketReg16(socket_n, SocketOffsetAddr::rx_read_pointer);
+    const uint16_t read_pointer = rxReadPointer(socket_n);
+    // 2. Read data from the buffer
+    spiFrame.transfer(SpiFrame::Frame{read_pointer, socket_n, SpiFrame::RxBuffer, SpiFrame::Read}, data, len);
+    // 3. Update the read pointer & notify it to W5500 (RECV)
+    rxAdvance(socket_n, read_pointer + len, len);
 
-    //--- UDP-Header information in the first 8 bytes
-    if ( (udpMode != UdpHeaderMode::Raw) && (socketStatus(socket_n) == UDP_Open) ) {
-        uint8_t udp_header[8]; // 4-byte destination IP, 2-byte destination port, 2-byte length of data packet
-        if (rec_available < 8) {
-            return 0; // not enough data to read the header
+    return len;
+}
+
+/**
+ * @brief Receive a single UDP datagram, discarding the part that does not fit into the buffer
+ * @param socket_n Socket number (must be opened in UDP mode)
+ * @param data Pointer for the received payload
+ * @param len maximum length of the receiving payload
+ * @param info optional, filled with source IP & Port, original payload size and if the payload was truncated
+ * @param update_destination update UDP destination IP & Port of this socket to the source of the datagram
+ * @return actuall number of payload bytes received (0 also for an empty datagram, see info->size)
+ * The read pointer always advances to the end of the datagram, the discarded remainder is not transferred via SPI.
+ */
+uint16_t W5500::receiveDatagram(uint8_t socket_n, uint8_t *data, uint16_t len, DatagramInfo *info, bool update_destination) {
+    if (socketStatus(socket_n) != UDP_Open) {
+        return 0;
+    }
+    return receiveUdp(socket_n, data, len, info, update_destination);
+}
+
+
+/**
+ * @brief Send a UDP datagram to the given destination
+ * @param socket_n Socket number (must be opened in UDP mode)
+ * @param dest_ip Destination IP address
+ * @param dest_port Destination port number
+ * @param data Pointer to the sending data (will be overwritten with unimportant data)
+ * @param len length of the data
+ * @return actuall number of bytes sent, 0 if the socket is not open in UDP mode or the datagram does not fit into the TX buffer
+ * The destination is only written if it differs from the current one (cached on the host), in a single frame.
+ * Free space & write pointer are tracked on the host, so the TX buffer state is only read when necessary.
+ * The destination of the socket is left at dest_ip & dest_port.
+ */
+uint16_t W5500::sendTo(uint8_t socket_n, const IP_t dest_ip, Port_t dest_port, uint8_t *data, uint16_t len) {
+    if (socketStatus(socket_n) != UDP_Open) {
+        return 0;
+    }
+    // coalesced data goes to the previous destination
+    if (! flush(socket_n)) {
+        return 0;
+    }
+    // free space only grows while sending -> read it only if the known free space is too small
+    SocketState &state = socket_state[socket_n];
+    if (len > state.tx_free) {
+        sendAvailable(socket_n);
+    }
+    // a datagram is never split
+    if ( (len == 0) || (len > state.tx_free) ) {
+        return 0;
+    }
+
+    //=== Write Operation
+    // 1. Write data behind the datagram currently being sent
+    spiFrame.transfer(SpiFrame::Frame{txWritePointer(socket_n), socket_n, SpiFrame::TxBuffer, SpiFrame::Write}, data, len);
+    state.tx_pointer += len;
+    state.tx_pending = len;
+    // 2. Destination & write pointer must not change until the previous SEND is completed
+    if (! waitSendComplete(socket_n)) {
+        txDiscard(socket_n);
+        return 0;
+    }
+    // 3. Update the destination (only written if it changed) & send the datagram
+    updateSocketDest(socket_n, dest_ip, dest_port);
+    txCommit(socket_n);
+
+    return len;
+}
+
+/**
+ * @brief Send all data to socket, waiting for free space in the TX buffer as required
+ * @param socket_n Socket number
+ * @param data Pointer to the sending data (will be overwritten with unimportant data)
+ * @param len length of the data (may exceed the TX buffer size)
+ * @return actuall number of bytes sent, less than len on timeout or if the socket got disconnected
+ * The next chunk is written into the TX buffer as soon as space is freed (also while the previous SEND is in progress).
+ * Other tasks are served between chunks (SpiFrame::yield). Intended for TCP - in UDP mode each chunk is a datagram.
+ */
+uint32_t W5500::sendAll(uint8_t socket_n, uint8_t *data, uint32_t len, float timeout) {
+    // coalesced data is sent first
+    if (! flush(socket_n)) {
+        return 0;
+    }
+    const uint32_t start_time = spiFrame.time_ms();
+    const uint32_t timeout_ms = static_cast<uint32_t>(timeout * 1000);
+
+    SocketState &state = socket_state[socket_n];
+    uint32_t sent = 0;      // bytes sent (SEND issued), state.tx_pending: written but not yet sent
+
+    while (sent < len) {
+        // status check without side effects - CLOSE_WAIT (peer closed) is still sendable and
+        // must not be disconnected by the maintenance in "socketStatus" while sending
+        if (! socketSendable(socket_n)) {
+            break;
         }
-        // read Packet-Info header
-        spiFrame.transfer(SpiFrame::Frame{read_pointer, socket_n, SpiFrame::RxBuffer, SpiFrame::Read}, udp_header, 8);
-        uint16_t payload_size = static_cast<uint16_t>(udp_header[6]) << 8 | udp_header[7];
-        len = std::min(len, payload_size); // read only one UDP data packet
-        len = std::min(len, static_cast<uint16_t>(rec_available-8)); // reduce by Packet-Info size
-        read_pointer  += 8; // increase past Packet-Info header
-        // Update Destination IP & Port of this socket
-        if(udpMode == UdpHeaderMode::UpdateDestination) {
-            uint16_t dest_port = (udp_header[4] << 8) | udp_header[5];
-            setSocketDest(socket_n, udp_header, dest_port);
+        // 1. Write the next chunk as soon as there is free space
+        state.tx_free = rdSocketReg16_atomic(socket_n, SocketOffsetAddr::tx_free_size);
+        const uint16_t chunk = std::min<uint32_t>(state.tx_free - state.tx_pending, len - sent - state.tx_pending);
+        if (chunk > 0) {
+            spiFrame.transfer(SpiFrame::Frame{txWritePointer(socket_n), socket_n, SpiFrame::TxBuffer, SpiFrame::Write},
+                              data + sent + state.tx_pending, chunk);
+            state.tx_pointer += chunk;
+            state.tx_pending += chunk;
+        }
+        // 2. Send the written data once the previous SEND is completed
+        const uint16_t written = state.tx_pending;
+        const bool progress = (written > 0) && sendCompleted(socket_n);
+        if (progress) {
+            txCommit(socket_n);
+            sent += written;
+        }
+        if ( (spiFrame.time_ms() - start_time) >= timeout_ms) {
+            break;
+        }
+        if (! progress) {
+            spiFrame.yield();
         }
     }
-    // 2. Read data from the buffer
+    // drop data written but not sent (timeout / disconnected)
+    txDiscard(socket_n);
+    return sent;
+}
+
+/**
+ * @brief Read received data without removing it from the RX buffer
+ * @param socket_n Socket number
+ * @param data Pointer for the received data
+ * @param len maximum length of the receiving data
+ * @param offset number of bytes to skip before reading (default: 0)
+ * @return actuall number of bytes read
+ * The read pointer is not changed, no RECV command is issued. In UDP mode the Packet-Info header is included.
+ */
+uint16_t W5500::peek(uint8_t socket_n, uint8_t *data, uint16_t len, uint16_t offset) {
+    const uint16_t rec_available = receiveAvailable(socket_n);
+    if (offset >= rec_available) {
+        return 0;
+    }
+    len = std::min(len, static_cast<uint16_t>(rec_available - offset));
+    const uint16_t read_pointer = rxReadPointer(socket_n) + offset;
     spiFrame.transfer(SpiFrame::Frame{read_pointer, socket_n, SpiFrame::RxBuffer, SpiFrame::Read}, data, len);
-    // 3. Update the read pointer
-    wrSocketReg16(socket_n, SocketOffsetAddr::rx_read_pointer, read_pointer + len);
-    // 4. Notify the updated read pointer to W5500
-    socketCommand(socket_n, RECV);
+    return len;
+}
+
+/**
+ * @brief Remove received data from the RX buffer without reading it
+ * @param socket_n Socket number
+ * @param len maximum number of bytes to skip
+ * @return actuall number of bytes skipped
+ * Only the read pointer is updated (the data is not transferred via SPI), followed by the RECV command.
+ * In UDP mode the Packet-Info header counts as data.
+ */
+uint16_t W5500::skip(uint8_t socket_n, uint16_t len) {
+    len = std::min(len, receiveAvailable(socket_n));
+    if (len == 0) {
+        return 0;
+    }
+    rxAdvance(socket_n, rxReadPointer(socket_n) + len, len);
+    return len;
+}
+
+/**
+ * @brief Copy received data of a socket into the TX buffer of another socket (TCP, pipelined)
+ * @param socket_n Socket number (source)
+ * @param sink W5500 of the sink socket (may be this W5500)
+ * @param sink_socket Socket number (sink)
+ * @param buffers two chunk buffers (double buffering)
+ * @param chunk_len size of each chunk buffer
+ * @return number of bytes copied (as much as received & fits into the sink)
+ * The copy is split into chunks: while chunk k is written to the sink, chunk k+1 is read from the source
+ * ("SpiFrame::transfer_start", overlapping if the transport is asynchronous & the chips are on different buses).
+ * The pointers are updated only once per call: the sink is sent first, the source is acknowledged (RECV) only
+ * if the sink accepted the data - nothing is lost if the sink fails.
+ */
+uint16_t W5500::pipeTo(uint8_t socket_n, W5500 &sink, uint8_t sink_socket, uint8_t *buffers[2], uint16_t chunk_len) {
+    const uint16_t sink_available = sink.sendAvailable(sink_socket);
+    const uint16_t len = std::min(receiveAvailable(socket_n), sink_available);
+    if ((len == 0) || (chunk_len == 0)) {
+        return 0;
+    }
+    const uint16_t read_pointer = rxReadPointer(socket_n);
+    const uint16_t write_pointer = sink.txWritePointer(sink_socket);
+
+    // read the first chunk
+    uint16_t chunk = std::min(len, chunk_len);
+    spiFrame.transfer_start(SpiFrame::Frame{read_pointer, socket_n, SpiFrame::RxBuffer, SpiFrame::Read}, buffers[0], chunk);
+    spiFrame.transfer_wait();
+    uint8_t current = 0;
+    for (uint16_t offset = 0; offset < len; offset += chunk, current ^= 1) {
+        chunk = std::min(static_cast<uint16_t>(len - offset), chunk_len);
+        const uint16_t next_offset = offset + chunk;
+        const uint16_t next_chunk = std::min(static_cast<uint16_t>(len - next_offset), chunk_len);
+        // write chunk k to the sink, while reading chunk k+1 from the source
+        sink.spiFrame.transfer_start(SpiFrame::Frame{static_cast<uint16_t>(write_pointer + offset), sink_socket, SpiFrame::TxBuffer, SpiFrame::Write}, buffers[current], chunk);
+        if (next_chunk > 0) {
+            spiFrame.transfer_start(SpiFrame::Frame{static_cast<uint16_t>(read_pointer + next_offset), socket_n, SpiFrame::RxBuffer, SpiFrame::Read}, buffers[current ^ 1], next_chunk);
+        }
+        sink.spiFrame.transfer_wait();
+        if (next_chunk > 0) {
+            spiFrame.transfer_wait();
+        }
+    }
 
+    // send the data, acknowledge the source only on success
+    if (! sink.txAdvance(sink_socket, len, len == sink_available)) {
+        return 0;
+    }
+    rxAdvance(socket_n, read_pointer + len, len);
     return len;
 }
 
+/**
+ * @brief Send multiple UDP datagrams, each to its own destination
+ * @param socket_n Socket number (must be opened in UDP mode)
+ * @param datagrams Array of datagrams (the data of each datagram will be overwritten with unimportant data)
+ * @param count Number of datagrams in the array
+ * @return number of datagrams processed, the remaining ones were not sent (e.g. no space in TX buffer or timeout)
+ * The payload of the next datagram is written into the TX buffer while the previous one is still being sent.
+ * Only the SEND command and the destination registers wait for SEND_OK of the previous datagram.
+ * The destination is written only if it differs from the current one (see "sendTo"). Empty datagrams are skipped.
+ * The destination of the socket is left at the destination of the last datagram sent.
+ */
+uint16_t W5500::sendDatagrams(uint8_t socket_n, const Datagram datagrams[], uint16_t count) {
+    if (socketStatus(socket_n) != UDP_Open) {
+        return 0;
+    }
+    // coalesced data must be sent before (to its own destination)
+    if (! flush(socket_n)) {
+        return 0;
+    }
+
+    SocketState &state = socket_state[socket_n];
+    uint16_t i;
+    for (i = 0; i < count; i++) {
+        const Datagram &datagram = datagrams[i];
+        if (datagram.len == 0) {
+            continue;
+        }
+        // not enough space -> wait until the previous datagram has left the TX buffer
+        if (datagram.len > state.tx_free) {
+            if (! waitSendComplete(socket_n)) {
+                break;
+            }
+            state.tx_free = rdSocketReg16_atomic(socket_n, SocketOffsetAddr::tx_free_size);
+            if (datagram.len > state.tx_free) {
+                break; // datagram does not fit into the TX buffer
+            }
+        }
+        // 1. Write data behind the datagram currently being sent
+        spiFrame.transfer(SpiFrame::Frame{txWritePointer(socket_n), socket_n, SpiFrame::TxBuffer, SpiFrame::Write}, datagram.data, datagram.len);
+        state.tx_pointer += datagram.len;
+        state.tx_pending = datagram.len;
+        // 2. Destination & write pointer must not change until the previous SEND is completed
+        if (! waitSendComplete(socket_n)) {
+            txDiscard(socket_n);
+            break;
+        }
+        // 3. Update the destination (only written if it changed) & send the datagram
+        updateSocketDest(socket_n, datagram.dest_ip, datagram.dest_port);
+        txCommit(socket_n);
+    }
+    return i;
+}
+
+//=============================
+// Deferred RECV acknowledgement
+
+/**
+ * @brief Defer the RECV acknowledgement of received data (saves two SPI frames per "receive")
+ * @param socket_n Socket number
+ * @param threshold Acknowledge once this many bytes were read (0 = disable, RECV after every "receive")
+ * @param timeout Acknowledge at latest after this time in seconds (checked by "receiveAvailable" & "poll")
+ * The read pointer is kept on the host until the threshold or timeout is reached.
+ * The threshold is limited to half the RX buffer size, otherwise the TCP window would stall.
+ * Set the RX buffer size before, the setting is kept when the socket is re-opened.
+ */
+void W5500::setReceiveDeferral(uint8_t socket_n, uint16_t threshold, float timeout) {
+    flushReceive(socket_n);
+    const uint16_t half_buffer = static_cast<uint16_t>(getBufferSizeRx(socket_n)) * 1024 / 2;
+    socket_state[socket_n].rx_threshold = std::min(threshold, half_buffer);
+    socket_state[socket_n].rx_timeout_ms = static_cast<uint32_t>(timeout * 1000);
+}
+
+/**
+ * @brief Acknowledge all data read so far (write read pointer & RECV command)
+ * @param socket_n Socket number
+ * Only required with deferred RECV acknowledgement (see "setReceiveDeferral").
+ */
+void W5500::flushReceive(uint8_t socket_n) {
+    SocketState &state = socket_state[socket_n];
+    if (state.rx_pending == 0) {
+        return;
+    }
+    wrSocketReg16(socket_n, SocketOffsetAddr::rx_read_pointer, state.rx_pointer);
+    socketCommand(socket_n, RECV);
+    state.rx_pending = 0;
+}
+
+//=============================
+// Send coalescing
+
+/**
+ * @brief Coalesce small writes into fewer SEND commands (fewer TCP segments / UDP datagrams & SPI frames)
+ * @param socket_n Socket number
+ * @param threshold Issue SEND once this many bytes were written (0 = disable, SEND after every "send")
+ * @param timeout Issue SEND at latest after this time in seconds (checked by "send", "sendAvailable" & "poll")
+ * The write pointer is kept on the host until the threshold or timeout is reached, or the TX buffer is full.
+ * In UDP mode, coalesced data is sent as a single datagram. The setting is kept when the socket is re-opened.
+ */
+void W5500::setSendCoalescing(uint8_t socket_n, uint16_t threshold, float timeout) {
+    flush(socket_n);
+    socket_state[socket_n].tx_threshold = threshold;
+    socket_state[socket_n].tx_timeout_ms = static_cast<uint32_t>(timeout * 1000);
+}
+
+/**
+ * @brief Send all coalesced data now (write pointer & SEND command)
+ * @param socket_n Socket number
+ * @return true if sent (or nothing to send), false if the previous SEND failed (coalesced data is dropped, see "sendDropped")
+ * Only required with send coalescing (see "setSendCoalescing").
+ */
+bool W5500::flush(uint8_t socket_n) {
+    SocketState &state = socket_state[socket_n];
+    if (state.tx_pending == 0) {
+        return true;
+    }
+    // a previous SEND must be completed before issuing the next one
+    if (! waitSendComplete(socket_n)) {
+        // already reported as sent by "send"
+        state.tx_dropped += state.tx_pending;
+        txDiscard(socket_n);
+        return false;
+    }
+    txCommit(socket_n);
+    return true;
+}
+
+/**
+ * @brief Number of coalesced bytes dropped since the last call (reported as sent by "send", but never sent)
+ * @param socket_n Socket number
+ * @return dropped bytes - the counter is cleared
+ * Coalesced data is dropped if the previous SEND failed (see "flush") or the socket was closed / aborted
+ * without a TCP disconnect. Always 0 without send coalescing.
+ */
+uint32_t W5500::sendDropped(uint8_t socket_n) {
+    const uint32_t dropped = socket_state[socket_n].tx_dropped;
+    socket_state[socket_n].tx_dropped = 0;
+    return dropped;
+}
+
+
+//=======================================================
+// Socket Allocation
+//=======================================================
+
+/**
+ * @brief Allocate any free socket of this chip
+ * @param socket_n allocated socket number (output)
+ * @return true if a socket was allocated, false if all sockets are in use
+ * Host-side bookkeeping only (no SPI access) - the socket is not opened or configured.
+ * Sockets used with fixed numbers should be reserved with "reserveSocket" first.
+ */
+bool W5500::allocateSocket(uint8_t &socket_n) {
+    uint8_t free_mask = freeSockets();
+    if (free_mask == 0) return false;
+    socket_n = __builtin_ctz(free_mask); // lowest free socket
+    socket_allocated |= (1 << socket_n);
+    return true;
+}
+
+/**
+ * @brief Reserve a specific socket (e.g. a socket with a fixed purpose)
+ * @param socket_n Socket number
+ * @return true if reserved, false if the socket was already allocated
+ */
+bool W5500::reserveSocket(uint8_t socket_n) {
+    if (socket_allocated & (1 << socket_n)) return false;
+    socket_allocated |= (1 << socket_n);
+    return true;
+}
+
+/**
+ * @brief Release an allocated or reserved socket (the socket is not closed)
+ * @param socket_n Socket number
+ */
+void W5500::releaseSocket(uint8_t socket_n) {
+    socket_allocated &= ~(1 << socket_n);
+}
+
+/**
+ * @brief Get the sockets not allocated or reserved
+ * @return bitmask of free sockets (bit n = socket n) - sockets still closing (see "socketCloseAsync") are not free
+ */
+uint8_t W5500::freeSockets() const {
+    return (uint8_t)~(socket_allocated | close_pending);
+}
+
+
+//=======================================================
+// Maintenance
+//=======================================================
+
+/**
+ * @brief Periodic maintenance of host-side socket state (call regularly, e.g. in the main loop)
+ * Acknowledges deferred RECV, sends coalesced data whose timeout expired & advances non-blocking opens & closes
+ * (see "socketOpenAsync", "socketCloseAsync"). No SPI traffic if there is nothing to do.
+ */
+void W5500::poll() {
+    for (uint8_t socket_n = 0; socket_n < Socket_MAX; socket_n++) {
+        switch (socket_state[socket_n].open_state) {
+            case Open_Closing:
+            case Open_Init:
+            case Open_Connecting:
+                openStep(socket_n);
+                break;
+            default:
+                break;
+        }
+        if (close_pending & (1 << socket_n)) {
+            closeStep(socket_n);
+        }
+        if (rxDeferralExpired(socket_n)) {
+            flushReceive(socket_n);
+        }
+        if (txCoalescingExpired(socket_n)) {
+            flush(socket_n);
+        }
+    }
+}
+
 
 //=======================================================
 // IP & Port configuration
@@ -323,7 +953,34 @@ void W5500::setInterfaceNetwork(const IP_t source_ip, const IP_t subnet_mask, co
     regInterfaceAddress(SubnetMask, true, ip_buffer, sizeof(IP_t));
     memcpy(ip_buffer, gateway, sizeof(IP_t));
     regInterfaceAddress(GatewayIP, true, ip_buffer, sizeof(IP_t));
-    
+    // keep a shadow copy (regInterfaceAddress invalidated it)
+    memcpy(interface_network.source_ip, source_ip, sizeof(IP_t));
+    memcpy(interface_network.subnet_mask, subnet_mask, sizeof(IP_t));
+    memcpy(interface_network.gateway, gateway, sizeof(IP_t));
+    interface_network.valid = true;
+}
+
+/**
+ * @brief Get the network configuration of the interface
+ * @param source_ip source IP address (output)
+ * @param subnet_mask subnet mask (output)
+ * @param gateway gateway IP address (output)
+ * Returns the shadow copy of "setInterfaceNetwork" without SPI access.
+ * If the configuration was not set by this object, the registers are read once (single burst) and cached.
+ */
+void W5500::getInterfaceNetwork(IP_t source_ip, IP_t subnet_mask, IP_t gateway) {
+    if (!interface_network.valid) {
+        // Gateway (0x0001) to Source IP (0x000F - 0x0012) in a single burst
+        uint8_t buffer[CommonOffsetAddr::source_ip + sizeof(IP_t) - CommonOffsetAddr::gateway_ip];
+        commonReg(CommonOffsetAddr::gateway_ip, false, buffer, sizeof(buffer));
+        memcpy(interface_network.gateway, &buffer[0], sizeof(IP_t));
+        memcpy(interface_network.subnet_mask, &buffer[CommonOffsetAddr::subnet_mask - CommonOffsetAddr::gateway_ip], sizeof(IP_t));
+        memcpy(interface_network.source_ip, &buffer[CommonOffsetAddr::source_ip - CommonOffsetAddr::gateway_ip], sizeof(IP_t));
+        interface_network.valid = true;
+    }
+    memcpy(source_ip, interface_network.source_ip, sizeof(IP_t));
+    memcpy(subnet_mask, interface_network.subnet_mask, sizeof(IP_t));
+    memcpy(gateway, interface_network.gateway, sizeof(IP_t));
 }
 
 void W5500::setInterfaceMAC(const MAC_t source_mac) {
@@ -352,8 +1009,7 @@ void W5500::setSocketSource(uint8_t socket_n, Port_t source_port) {
  * @param dest_port destination port number
  */
 void W5500::setSocketDest(uint8_t socket_n, const IP_t dest_ip, Port_t dest_port) {
-    setSocketDestIP(socket_n, dest_ip);
-    wrSocketReg16(socket_n, SocketOffsetAddr::destination_port, dest_port);
+    updateSocketDest(socket_n, dest_ip, dest_port);
 }
 
 //=============================
@@ -368,6 +1024,7 @@ void W5500::setSocketDest(uint8_t socket_n, const IP_t dest_ip, Port_t dest_port
 void W5500::setSocketPorts(uint8_t socket_n, Port_t port) {
     wrSocketReg16(socket_n, SocketOffsetAddr::source_port, port);
     wrSocketReg16(socket_n, SocketOffsetAddr::destination_port, port);
+    socket_state[socket_n].dest_valid = false;
 }
 
 /**
@@ -383,6 +1040,7 @@ void W5500::setSocketPort(uint8_t socket_n, SocketPort select, Port_t port) {
             break;
         case DestinationPort:
             wrSocketReg16(socket_n, SocketOffsetAddr::destination_port, port);
+            socket_state[socket_n].dest_valid = false;
             break;
     }
 }
@@ -453,6 +1111,9 @@ void W5500::regInterfaceAddress(InterfaceAddress select, bool write, uint8_t *da
     max_len -= offset; // adjust for offset
     if (max_len <= 0) return; // offset too large
     len = std::min(len, (uint8_t)(max_len));
+    if (write && (select != SourceMAC)) {
+        interface_network.valid = false;
+    }
     commonReg((CommonOffsetAddr)(socket_addr + offset), write, data, len);
 }
 
@@ -484,6 +1145,9 @@ void W5500::regSocketAddress(uint8_t socket_n, SocketAddress select, bool write,
     max_len -= offset; // adjust for offset
     if (max_len <= 0) return; // offset too large
     len = std::min(len, (uint8_t)(max_len));
+    if (write && (select == DestinationIP)) {
+        socket_state[socket_n].dest_valid = false;
+    }
     socketReg(socket_n, (SocketOffsetAddr)(socket_addr + offset), write, data, len);
 }
 
@@ -528,6 +1192,58 @@ uint8_t W5500::getBufferSizeTx(uint8_t socket_n) {
     return rdSocketReg(socket_n, SocketOffsetAddr::txbuf_size);
 }
 
+//=============================
+// TCP Retransmission & Socket Timeouts
+
+/**
+ * @brief Set the TCP retransmission (common to all sockets, reset by "init")
+ * @param retry_time Retransmission timeout in seconds (100 us - 6.5 s, default: 0.2 s)
+ * @param retry_count Number of retransmissions (default: 8), then Event_Timeout & the socket is closed
+ * Also applies to ARP requests & the TCP connect. E.g. 0.005 s & 3 retries detect a dead peer on a LAN
+ * within tens of milliseconds (the timeout doubles with each retransmission).
+ */
+void W5500::setRetransmission(float retry_time, uint8_t retry_count) {
+    const float ticks = retry_time * 10000;
+    const uint16_t value = (ticks < 1) ? 1 : ( (ticks > 0xFFFF) ? 0xFFFF : static_cast<uint16_t>(ticks) );
+    // registers are contiguous: 0x0019 - 0x001B
+    uint8_t data[3] = {static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value & 0xFF), retry_count};
+    commonReg(CommonOffsetAddr::retry_time, true, data, sizeof(data));
+}
+
+/**
+ * @brief Get the TCP retransmission
+ * @param retry_time Retransmission timeout in seconds (output)
+ * @param retry_count Number of retransmissions (output)
+ */
+void W5500::getRetransmission(float &retry_time, uint8_t &retry_count) {
+    uint8_t data[3];
+    commonReg(CommonOffsetAddr::retry_time, false, data, sizeof(data));
+    retry_time = ((data[0] << 8) | data[1]) / 10000.0;
+    retry_count = data[2];
+}
+
+/**
+ * @brief Set the timeout of a socket operation (host-side, no SPI access)
+ * @param socket_n Socket number
+ * @param operation operation (Timeout_Open, Timeout_Close, Timeout_Send)
+ * @param timeout Timeout in seconds (default: 3 s)
+ * The timeouts should be longer than the TCP retransmission (see "setRetransmission"), so a dead peer is
+ * reported by the W5500 (Event_Timeout) before the host gives up.
+ */
+void W5500::setSocketTimeout(uint8_t socket_n, SocketTimeout operation, float timeout) {
+    socket_state[socket_n].timeout_ms[operation] = static_cast<uint32_t>(timeout * 1000);
+}
+
+/**
+ * @brief Get the timeout of a socket operation
+ * @param socket_n Socket number
+ * @param operation operation
+ * @return Timeout in seconds
+ */
+float W5500::getSocketTimeout(uint8_t socket_n, SocketTimeout operation) const {
+    return socket_state[socket_n].timeout_ms[operation] / 1000.0;
+}
+
 
 //=======================================================
 // Status
@@ -553,6 +1269,40 @@ uint8_t W5500::phyStatus() {
     return rdCommonReg(CommonOffsetAddr::phy_config) & 0x07;
 }
 
+/**
+ * @brief Get the sockets with pending events (common socket interrupt register)
+ * @return bit n set: socket n has events (see "socketEvents")
+ */
+uint8_t W5500::pendingEvents() {
+    return rdCommonReg(CommonOffsetAddr::socket_interrupt);
+}
+
+/**
+ * @brief Read & acknowledge the events of a socket (socket interrupt register)
+ * @param socket_n Socket number
+ * @return SocketEvent bits that occurred since the last call
+ * Event_SendOK of a pending SEND is taken into account for the next SEND command (see "send").
+ * Event_Timeout is also reported if it was acknowledged while waiting for a SEND to complete.
+ * Event_KeepAliveTimeout is added to Event_Timeout if keep-alive is used & no SEND was pending.
+ */
+uint8_t W5500::socketEvents(uint8_t socket_n) {
+    uint8_t events = rdSocketReg(socket_n, SocketOffsetAddr::interrupt_register);
+    if (events != 0) {
+        wrSocketReg(socket_n, SocketOffsetAddr::interrupt_register, events);
+    }
+    if ( (events & INT_TIMEOUT) && (keep_alive & (1 << socket_n)) && !(send_pending & (1 << socket_n)) ) {
+        events |= Event_KeepAliveTimeout;
+    }
+    if (events & (INT_SEND_OK | INT_TIMEOUT)) {
+        send_pending &= ~(1 << socket_n);
+    }
+    if (timeout_events & (1 << socket_n)) {
+        events |= INT_TIMEOUT;
+        timeout_events &= ~(1 << socket_n);
+    }
+    return events;
+}
+
 /**
  * @brief Get the W5500 chip version
  * @return W5500 chip version register value (expected: 0x04)
@@ -562,6 +1312,27 @@ uint8_t W5500::chipVersion() {
 }
 
 
+//=======================================================
+// Timing
+//=======================================================
+
+/**
+ * @brief Wait (using the SPI frame's sleep, e.g. to share a delay between multiple W5500)
+ * @param seconds Time to sleep in seconds
+ */
+void W5500::sleep(float seconds) {
+    spiFrame.sleep(seconds);
+}
+
+/**
+ * @brief Current time of the SPI frame's clock
+ * @return Time in milliseconds (wraps around, compare differences only)
+ */
+uint32_t W5500::timeMs() {
+    return spiFrame.time_ms();
+}
+
+
 //=======================================================
 // Register Operations
 //=======================================================
@@ -641,6 +1412,120 @@ W5500::SocketStatusReg W5500::socketStatusReg(uint8_t socket_n) {
     return (SocketStatusReg)rdSocketReg(socket_n, SocketOffsetAddr::status_register);
 }
 
+// socket can send data (TCP established or half-closed by the peer, UDP)
+bool W5500::socketSendable(uint8_t socket_n) {
+    switch(socketStatusReg(socket_n)) {
+        case SOCK_ESTABLISHED:
+        case SOCK_CLOSE_WAIT:
+        case SOCK_UDP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// socket can have received data (TCP established or half-closed, UDP)
+bool W5500::socketReceivable(uint8_t socket_n) {
+    switch(socketStatusReg(socket_n)) {
+        case SOCK_ESTABLISHED:
+        case SOCK_CLOSE_WAIT:
+        case SOCK_FIN_WAIT:
+        case SOCK_UDP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//=============================
+// Non-blocking Open
+
+// value of the socket mode register (protocol)
+uint8_t W5500::socketModeValue(SocketMode mode) {
+    switch (mode) {
+        case TCP_Server:
+        case TCP_Client:
+            return socket_mode_register_default | 0x01;
+        case UDP:
+        default:
+            return socket_mode_register_default | 0x02;
+    }
+}
+
+// set the mode & issue OPEN on a closed socket (next step: Open_Init)
+void W5500::openCommand(uint8_t socket_n) {
+    SocketState &state = socket_state[socket_n];
+    wrSocketReg(socket_n, SocketOffsetAddr::socket_mode_register, socketModeValue(state.open_mode));
+    socketCommand(socket_n, OPEN);
+    state.open_state = Open_Init;
+    state.open_deadline = socketDeadline(socket_n, Timeout_Open);
+}
+
+// advance a non-blocking open by one step (a single status read)
+void W5500::openStep(uint8_t socket_n) {
+    SocketState &state = socket_state[socket_n];
+    const uint8_t status = socketStatusReg(socket_n);
+    const bool expired = static_cast<int32_t>(timeMs() - state.open_deadline) >= 0;
+
+    switch (state.open_state) {
+        case Open_Closing:
+            if (status == SOCK_CLOSED) {
+                openCommand(socket_n);
+            } else if (expired) {
+                // TCP disconnect timed out -> close immediately
+                socketCommand(socket_n, CLOSE);
+                openCommand(socket_n);
+            }
+            return;
+        case Open_Init:
+            if ( (state.open_mode == UDP) && (status == SOCK_UDP) ) {
+                state.open_state = Open_Established;
+                return;
+            }
+            if ( (state.open_mode != UDP) && (status == SOCK_INIT) ) {
+                socketCommand(socket_n, (state.open_mode == TCP_Server) ? LISTEN : CONNECT);
+                state.open_state = Open_Connecting;
+                state.open_deadline = socketDeadline(socket_n, Timeout_Open);
+                return;
+            }
+            break;
+        case Open_Connecting:
+            // a client may connect to a server (or the peer close) before this step
+            if ( (status == SOCK_ESTABLISHED) || (status == SOCK_CLOSE_WAIT) ||
+                 ((state.open_mode == TCP_Server) && ((status == SOCK_LISTEN) || (status == SOCK_SYNRECV))) ) {
+                state.open_state = Open_Established;
+                return;
+            }
+            if (status == SOCK_CLOSED) {
+                // connection refused or TCP timeout
+                state.open_state = Open_Failed;
+                return;
+            }
+            break;
+        default:
+            return;
+    }
+    if (expired) {
+        socketCommand(socket_n, CLOSE);
+        state.open_state = Open_Failed;
+    }
+}
+
+// time limit of an operation started now
+uint32_t W5500::socketDeadline(uint8_t socket_n, SocketTimeout operation) {
+    return timeMs() + socket_state[socket_n].timeout_ms[operation];
+}
+
+// check a non-blocking close (a single status read), CLOSE once the deadline is reached
+void W5500::closeStep(uint8_t socket_n) {
+    if (socketStatusReg(socket_n) == SOCK_CLOSED) {
+        close_pending &= ~(1 << socket_n);
+    } else if (static_cast<int32_t>(timeMs() - socket_state[socket_n].close_deadline) >= 0) {
+        socketCommand(socket_n, CLOSE);
+        close_pending &= ~(1 << socket_n);
+    }
+}
+
 /**
  * @brief Wait for a socket to reach a certain status or timeout
  * @param socket_n Socket number
@@ -654,6 +1539,221 @@ bool W5500::waitSocketStatus(uint8_t socket_n, SocketStatusReg status, float tim
 }
 
 
+//=============================
+// SEND Command & Completion
+
+// issue the SEND command & remember to wait for its SEND_OK (see "waitSendComplete")
+void W5500::sendCommand(uint8_t socket_n) {
+    socketCommand(socket_n, SEND);
+    send_pending |= (1 << socket_n);
+}
+
+/**
+ * @brief Wait until the previous SEND command of a socket is completed (SEND_OK)
+ * @param socket_n Socket number
+ * @return true if no SEND is pending (anymore) or it completed with SEND_OK,
+ * false if the SEND failed (TIMEOUT, e.g. TCP retransmission timeout) or the Timeout_Send of the socket was reached
+ * The W5500 requires a SEND to be completed before the next SEND command is issued.
+ * SEND_OK & TIMEOUT (SEND failed, reported by "socketEvents") are cleared, so the next SEND can be tracked.
+ */
+bool W5500::waitSendComplete(uint8_t socket_n) {
+    if ( (send_pending & (1 << socket_n)) == 0) {
+        return true;
+    }
+    const SpiFrame::Frame frame = {SocketOffsetAddr::interrupt_register, socket_n, SpiFrame::SocketReg, SpiFrame::Read};
+    const uint8_t events = spiFrame.wait_for_any(frame, INT_SEND_OK | INT_TIMEOUT, getSocketTimeout(socket_n, Timeout_Send));
+    wrSocketReg(socket_n, SocketOffsetAddr::interrupt_register, INT_SEND_OK | INT_TIMEOUT);
+    if (events & INT_TIMEOUT) {
+        timeout_events |= (1 << socket_n);
+    }
+    send_pending &= ~(1 << socket_n);
+    return (events & INT_SEND_OK) != 0;
+}
+
+//=============================
+// RX Buffer read pointer
+
+// starting address for reading: host-side read pointer with not acknowledged data, W5500 register otherwise
+uint16_t W5500::rxReadPointer(uint8_t socket_n) {
+    const SocketState &state = socket_state[socket_n];
+    if (state.rx_pending > 0) {
+        return state.rx_pointer;
+    }
+    return rdSocketReg16(socket_n, SocketOffsetAddr::rx_read_pointer);
+}
+
+// advance the read pointer by len bytes - acknowledge (RECV) now or defer (see "setReceiveDeferral")
+void W5500::rxAdvance(uint8_t socket_n, uint16_t read_pointer, uint16_t len) {
+    SocketState &state = socket_state[socket_n];
+    if (state.rx_pending == 0) {
+        state.rx_pending_since = spiFrame.time_ms();
+    }
+    state.rx_pointer = read_pointer;
+    state.rx_pending += len;
+    if ( (state.rx_pending >= state.rx_threshold) || rxDeferralExpired(socket_n) ) {
+        flushReceive(socket_n);
+    }
+}
+
+// true if not acknowledged data is waiting longer than the deferral timeout
+bool W5500::rxDeferralExpired(uint8_t socket_n) {
+    const SocketState &state = socket_state[socket_n];
+    return (state.rx_pending > 0) && ( (spiFrame.time_ms() - state.rx_pending_since) >= state.rx_timeout_ms );
+}
+
+//=============================
+// TX Buffer write pointer
+
+// starting address for writing: host-side write pointer (read from the W5500 once after opening the socket)
+uint16_t W5500::txWritePointer(uint8_t socket_n) {
+    SocketState &state = socket_state[socket_n];
+    if (! state.tx_pointer_valid) {
+        state.tx_pointer = rdSocketReg16(socket_n, SocketOffsetAddr::tx_write_pointer);
+        state.tx_pointer_valid = true;
+    }
+    return state.tx_pointer;
+}
+
+// advance the write pointer by len bytes - send (SEND) now or coalesce (see "setSendCoalescing")
+bool W5500::txAdvance(uint8_t socket_n, uint16_t len, bool buffer_full) {
+    SocketState &state = socket_state[socket_n];
+    if (state.tx_pending == 0) {
+        state.tx_pending_since = spiFrame.time_ms();
+    }
+    state.tx_pointer += len;
+    state.tx_pending += len;
+    if ( buffer_full || (state.tx_pending >= state.tx_threshold) || txCoalescingExpired(socket_n) ) {
+        if (! flush(socket_n)) {
+            // the current data is reported by the caller (not sent), only earlier data counts as dropped
+            state.tx_dropped -= len;
+            return false;
+        }
+    }
+    return true;
+}
+
+// send all written data: update the write pointer & issue SEND (a previous SEND must be completed)
+void W5500::txCommit(uint8_t socket_n) {
+    SocketState &state = socket_state[socket_n];
+    wrSocketReg16(socket_n, SocketOffsetAddr::tx_write_pointer, state.tx_pointer);
+    sendCommand(socket_n);
+    state.tx_free -= std::min(state.tx_free, state.tx_pending);
+    state.tx_pending = 0;
+}
+
+// drop written but not sent data (the write pointer of the W5500 was not updated yet)
+void W5500::txDiscard(uint8_t socket_n) {
+    SocketState &state = socket_state[socket_n];
+    state.tx_pointer -= state.tx_pending;
+    state.tx_pending = 0;
+}
+
+// true if not sent data is waiting longer than the coalescing timeout
+bool W5500::txCoalescingExpired(uint8_t socket_n) {
+    const SocketState &state = socket_state[socket_n];
+    return (state.tx_pending > 0) && ( (spiFrame.time_ms() - state.tx_pending_since) >= state.tx_timeout_ms );
+}
+
+/**
+ * @brief Check (without waiting) if the previous SEND command of a socket is completed
+ * @param socket_n Socket number
+ * @return true if no SEND is pending (anymore) - the next "send" does not wait
+ * SEND_OK & TIMEOUT are acknowledged like in "waitSendComplete".
+ */
+bool W5500::sendCompleted(uint8_t socket_n) {
+    if ( (send_pending & (1 << socket_n)) == 0) {
+        return true;
+    }
+    const uint8_t events = rdSocketReg(socket_n, SocketOffsetAddr::interrupt_register) & (INT_SEND_OK | INT_TIMEOUT);
+    if (events == 0) {
+        return false;
+    }
+    wrSocketReg(socket_n, SocketOffsetAddr::interrupt_register, INT_SEND_OK | INT_TIMEOUT);
+    if (events & INT_TIMEOUT) {
+        timeout_events |= (1 << socket_n);
+    }
+    send_pending &= ~(1 << socket_n);
+    return true;
+}
+
+// receive one UDP datagram (socket must be in UDP mode) - see "receiveDatagram"
+uint16_t W5500::receiveUdp(uint8_t socket_n, uint8_t *data, uint16_t len, DatagramInfo *info, bool update_destination) {
+    const uint16_t rec_available = receiveAvailable(socket_n);
+    if (rec_available < 8) {
+        return 0; // not enough data to read the header
+    }
+
+    //=== Read Operation
+    // 1. Read starting address & Packet-Info header
+    uint16_t read_pointer = rxReadPointer(socket_n);
+    uint8_t udp_header[8]; // 4-byte source IP, 2-byte source port, 2-byte length of data packet
+    spiFrame.transfer(SpiFrame::Frame{read_pointer, socket_n, SpiFrame::RxBuffer, SpiFrame::Read}, udp_header, 8);
+    read_pointer += 8;
+    const Port_t source_port = (udp_header[4] << 8) | udp_header[5];
+    const uint16_t payload_size = (udp_header[6] << 8) | udp_header[7];
+    // the W5500 stores complete datagrams - limit to the received data in case of an inconsistent header
+    const uint16_t stored_size = std::min(payload_size, static_cast<uint16_t>(rec_available - 8));
+    len = std::min(len, stored_size);
+    // 2. Read payload from the buffer
+    if (len > 0) {
+        spiFrame.transfer(SpiFrame::Frame{read_pointer, socket_n, SpiFrame::RxBuffer, SpiFrame::Read}, data, len);
+    }
+    // 3. Update the read pointer past the complete datagram & notify it to W5500 (RECV)
+    rxAdvance(socket_n, read_pointer + stored_size, 8 + stored_size);
+
+    if (info != nullptr) {
+        memcpy(info->source_ip, udp_header, sizeof(IP_t));
+        info->source_port = source_port;
+        info->size = payload_size;
+        info->truncated = (len < payload_size);
+    }
+    if (update_destination) {
+        updateSocketDest(socket_n, udp_header, source_port);
+    }
+    return len;
+}
+
+// forget host-side buffer tracking of a socket & cancel a non-blocking open / close (socket closed or W5500 reset) - settings are kept,
+// except keep-alive (configured per connection, see "setKeepAlive")
+void W5500::resetSocketState(uint8_t socket_n) {
+    if (keep_alive & (1 << socket_n)) {
+        wrSocketReg(socket_n, SocketOffsetAddr::keep_alive_timer, 0);
+        keep_alive &= ~(1 << socket_n);
+    }
+    // no SEND_OK will follow on a closed socket & not acknowledged / not sent data is dropped
+    send_pending &= ~(1 << socket_n);
+    SocketState &state = socket_state[socket_n];
+    state.tx_dropped += state.tx_pending;   // coalesced data not sent
+    state.rx_pending = 0;
+    state.tx_pointer_valid = false;
+    state.tx_free = 0;
+    state.tx_pending = 0;
+    state.open_state = Open_Idle;
+    // a TCP server socket gets its destination written by the W5500 (connecting client) - write it again after re-opening
+    state.dest_valid = false;
+    close_pending &= ~(1 << socket_n);
+}
+
+// write destination IP & Port with a single frame (registers are contiguous: 0x000C - 0x0011)
+void W5500::wrSocketDest(uint8_t socket_n, const IP_t dest_ip, Port_t dest_port) {
+    uint8_t data[6] = {dest_ip[0], dest_ip[1], dest_ip[2], dest_ip[3],
+                       static_cast<uint8_t>(dest_port >> 8), static_cast<uint8_t>(dest_port & 0xFF)};
+    socketReg(socket_n, SocketOffsetAddr::destination_ip, true, data, sizeof(data));
+}
+
+// set destination IP & Port - only written if different from the cached destination
+void W5500::updateSocketDest(uint8_t socket_n, const IP_t dest_ip, Port_t dest_port) {
+    SocketState &state = socket_state[socket_n];
+    if ( state.dest_valid && (state.dest_port == dest_port) && (memcmp(state.dest_ip, dest_ip, sizeof(IP_t)) == 0) ) {
+        return;
+    }
+    wrSocketDest(socket_n, dest_ip, dest_port);
+    memcpy(state.dest_ip, dest_ip, sizeof(IP_t));
+    state.dest_port = dest_port;
+    state.dest_valid = true;
+}
+
+
 //=============================
 // Common & Scoket - Register Read/Write
 
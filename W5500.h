@@ -30,18 +30,66 @@ public:
         TCP_Connected   = 3, // TCP connection established (client or server)
         Temporary       = 4, // temporary states of W5500
     };
+    // Detailed TCP state (half-close), see `tcpState`
+    enum TcpState{
+        TCP_Closed,         // closed (or not a TCP socket)
+        TCP_Opening,        // initialized, listening or connecting
+        TCP_Established,    // connection established
+        TCP_PeerClosed,     // FIN received - remaining data can be read, sending is still possible
+        TCP_LocalClosed,    // FIN sent ("socketShutdown") - receiving is still possible until the peer closes
+    };
+    // Progress of a non-blocking socket open, see `socketOpenAsync`
+    enum OpenState{
+        Open_Idle,          // no non-blocking open started (or socket closed locally since, e.g. "socketClose")
+        Open_Closing,       // closing the previous connection
+        Open_Init,          // OPEN issued, waiting for the socket to be initialized
+        Open_Connecting,    // LISTEN / CONNECT issued
+        Open_Established,   // socket opened (UDP), listening (TCP_Server) or connected (TCP_Client)
+        Open_Failed,        // timeout, connection refused or PHY link down
+    };
     // UDP receive data has a Packet-Info header - define how to handle it
     enum UdpHeaderMode{
         Raw,                // Return Packet-Info + payload
         PayloadOnly,        // Ignore Packet-Info, return only payload
         UpdateDestination,  // update UDP destination IP & Port, return only payload
     };
+    // Timeouts of socket operations (per socket), see `setSocketTimeout`
+    enum SocketTimeout{
+        Timeout_Open,       // each step of socketOpen / socketOpenAsync (incl. the TCP connect)
+        Timeout_Close,      // TCP disconnect of socketClose / socketCloseAsync
+        Timeout_Send,       // completion of the previous SEND (SEND_OK) before the next one
+    };
+    // Socket events (Sn_IR bits), see `socketEvents`
+    enum SocketEvent{
+        Event_Connected     = 0x01, // TCP connection established
+        Event_Disconnected  = 0x02, // TCP FIN/RST received (or disconnect completed)
+        Event_Received      = 0x04, // data received
+        Event_Timeout       = 0x08, // ARP or TCP timeout (retransmissions exhausted, see `setRetransmission`)
+        Event_SendOK        = 0x10, // SEND command completed
+        Event_KeepAliveTimeout = 0x20, // Event_Timeout of an idle connection with keep-alive (host-side, see `setKeepAlive`)
+    };
     //-----------------------------
     // IP, MAC, Port - Types
     using IP_t = uint8_t[4];    // e.g. IP_t ip = {192, 168, 0, 1};
     using MAC_t = uint8_t[6];
     using Port_t = uint16_t;
 
+    //-----------------------------
+    // UDP Datagram (for sending multiple datagrams at once)
+    struct Datagram {
+        IP_t dest_ip;
+        Port_t dest_port;
+        uint8_t *data;  // will be overwritten with unimportant data (like `send`)
+        uint16_t len;
+    };
+    // Information about a received UDP datagram
+    struct DatagramInfo {
+        IP_t source_ip;
+        Port_t source_port;
+        uint16_t size;      // payload size of the datagram (as sent)
+        bool truncated;     // payload did not fit into the receive buffer, the remainder was discarded
+    };
+
     //-----------------------------
     // Address Selection
     enum InterfaceAddress{
@@ -62,6 +110,7 @@ public:
     //-----------------------------
     // Constants
     static constexpr uint8_t Socket_MAX = 8; // 0-7
+    static constexpr uint8_t Init_Steps = 3; // see `initStep`
 
     //=============================
     // Constructor
@@ -75,17 +124,29 @@ public:
     // Initialization
 
     void init();
+    float initStep(uint8_t step);
 
     //-----------------------------
     // Socket Managment
 
     bool socketOpen(uint8_t socket_n, SocketMode mode);
+    bool socketOpenAsync(uint8_t socket_n, SocketMode mode);
+    OpenState openState(uint8_t socket_n) const;
     void socketClose(uint8_t socket_n);
+    void socketAbort(uint8_t socket_n);
+    void socketCloseAsync(uint8_t socket_n);
+    bool socketClosing(uint8_t socket_n) const;
     void socketKeepOpen(uint8_t socket_n, SocketMode mode);
 
     SocketStatus socketStatus(uint8_t socket_n);
     bool socketConnected(uint8_t socket_n);
 
+    TcpState tcpState(uint8_t socket_n);
+    void socketShutdown(uint8_t socket_n);
+
+    void setKeepAlive(uint8_t socket_n, float interval);
+    bool sendKeepAlive(uint8_t socket_n);
+
     //-----------------------------
     // Send & Receive data
 
@@ -93,7 +154,45 @@ public:
     uint16_t receiveAvailable(uint8_t socket_n);
 
     uint16_t send(uint8_t socket_n, uint8_t *data, uint16_t len);
+    bool sendCompleted(uint8_t socket_n);
     uint16_t receive(uint8_t socket_n, uint8_t *data, uint16_t len, UdpHeaderMode udpMode = Raw);
+    uint16_t receiveDatagram(uint8_t socket_n, uint8_t *data, uint16_t len, DatagramInfo *info = nullptr, bool update_destination = false);
+
+    uint32_t sendAll(uint8_t socket_n, uint8_t *data, uint32_t len, float timeout);
+
+    uint16_t sendTo(uint8_t socket_n, const IP_t dest_ip, Port_t dest_port, uint8_t *data, uint16_t len);
+    uint16_t sendDatagrams(uint8_t socket_n, const Datagram datagrams[], uint16_t count);
+
+    uint16_t peek(uint8_t socket_n, uint8_t *data, uint16_t len, uint16_t offset = 0);
+    uint16_t skip(uint8_t socket_n, uint16_t len);
+
+    // Socket to socket copy (same or different W5500)
+
+    uint16_t pipeTo(uint8_t socket_n, W5500 &sink, uint8_t sink_socket, uint8_t *buffers[2], uint16_t chunk_len);
+
+    // Deferred RECV acknowledgement (for reading small chunks)
+
+    void setReceiveDeferral(uint8_t socket_n, uint16_t threshold, float timeout);
+    void flushReceive(uint8_t socket_n);
+
+    // Send coalescing (for sending small chunks)
+
+    void setSendCoalescing(uint8_t socket_n, uint16_t threshold, float timeout);
+    bool flush(uint8_t socket_n);
+    uint32_t sendDropped(uint8_t socket_n);
+
+    //-----------------------------
+    // Socket Allocation (host-side bookkeeping, no SPI access)
+
+    bool allocateSocket(uint8_t &socket_n);
+    bool reserveSocket(uint8_t socket_n);
+    void releaseSocket(uint8_t socket_n);
+    uint8_t freeSockets() const;
+
+    //-----------------------------
+    // Maintenance (call periodically)
+
+    void poll();
 
     //-----------------------------
     // MAC, IP & Port configuration
@@ -101,6 +200,7 @@ public:
     // Set Interface (common to all sockets)
 
     void setInterfaceNetwork(const IP_t source_ip, const IP_t subnet_mask, const IP_t gateway);
+    void getInterfaceNetwork(IP_t source_ip, IP_t subnet_mask, IP_t gateway);
     void setInterfaceMAC(const MAC_t source_mac);
     
     // Set Socket Source (all socket modes) & Destination (TCP_Client & UDP only)
@@ -127,12 +227,28 @@ public:
     uint8_t getBufferSizeRx(uint8_t socket_n);
     uint8_t getBufferSizeTx(uint8_t socket_n);
 
+    // TCP retransmission (common to all sockets) & timeouts of socket operations
+
+    void setRetransmission(float retry_time, uint8_t retry_count);
+    void getRetransmission(float &retry_time, uint8_t &retry_count);
+    void setSocketTimeout(uint8_t socket_n, SocketTimeout operation, float timeout);
+    float getSocketTimeout(uint8_t socket_n, SocketTimeout operation) const;
+
     //-----------------------------
     // Status
     
     bool phyLinkUp();
     uint8_t phyStatus();
     uint8_t chipVersion();
+
+    uint8_t pendingEvents();
+    uint8_t socketEvents(uint8_t socket_n);
+
+    //-----------------------------
+    // Timing
+
+    void sleep(float seconds);
+    uint32_t timeMs();
     
 
     //=============================
@@ -149,6 +265,9 @@ private:
         subnet_mask         = 0x0005,   // 0x0005 - 0x0008
         source_mac          = 0x0009,   // 0x0009 - 0x000E
         source_ip           = 0x000F,   // 0x000F - 0x0012
+        socket_interrupt    = 0x0017,
+        retry_time          = 0x0019,   // 0x0019 - 0x001A (unit: 100 us)
+        retry_count         = 0x001B,
         unreachable_ip      = 0x0028,   // 0x0028 - 0x002B
         unreachable_port    = 0x002C,   // 0x002C - 0x002D
         phy_config          = 0x002E,
@@ -157,6 +276,7 @@ private:
     enum SocketOffsetAddr{
         socket_mode_register= 0x0000,
         command_register    = 0x0001,
+        interrupt_register  = 0x0002,
         status_register     = 0x0003,
         // MAC, IP, Port
         source_port         = 0x0004,   // 0x0004 - 0x0005
@@ -173,6 +293,8 @@ private:
         rx_received_size    = 0x0026,   // 0x0026 - 0x0027
         rx_read_pointer     = 0x0028,   // 0x0028 - 0x0029
         rx_write_pointer    = 0x002A,   // 0x002A - 0x002B
+        // TCP keep-alive
+        keep_alive_timer    = 0x002F,   // unit: 5 s
     };
     //-----------------------------
     // Commands & Status - Values
@@ -183,14 +305,28 @@ private:
         DISCONNECT          = 0x08,
         CLOSE               = 0x10,
         SEND                = 0x20,
+        SEND_KEEP           = 0x22,
         RECV                = 0x40,
     };
+    enum SocketInterruptReg {
+        INT_CON             = 0x01,
+        INT_DISCON          = 0x02,
+        INT_RECV            = 0x04,
+        INT_TIMEOUT         = 0x08,
+        INT_SEND_OK         = 0x10,
+    };
     enum SocketStatusReg {
         SOCK_CLOSED         = 0x00,
         SOCK_INIT           = 0x13,
         SOCK_LISTEN         = 0x14,
+        SOCK_SYNSENT        = 0x15,
+        SOCK_SYNRECV        = 0x16,
         SOCK_ESTABLISHED    = 0x17,
+        SOCK_FIN_WAIT       = 0x18,
+        SOCK_CLOSING        = 0x1A,
+        SOCK_TIME_WAIT      = 0x1B,
         SOCK_CLOSE_WAIT     = 0x1C,
+        SOCK_LAST_ACK       = 0x1D,
         SOCK_UDP            = 0x22,
     };
 
@@ -208,12 +344,6 @@ private:
     // Socket Mode Bits - b7: 0=disable multicast (UDP), b6: 0=disable broadcast blocking (UDP), b5: 0=delayed ACK (TCP), b3: 0=disable unicast blocking (UDP)
     const uint8_t socket_mode_register_default = 0x00;
 
-    //-------------------
-    // Timeout Constants
-
-    // Single timeout for various operations
-    const float socket_timeout = 3.0; // seconds
-
 
     //=============================
     // Variables
@@ -221,6 +351,62 @@ private:
     // Class reference to the SPI communication
     SpiFrame &spiFrame;
 
+    // Sockets with an issued SEND command, whose SEND_OK was not yet acknowledged (bit n = socket n)
+    uint8_t send_pending = 0;
+
+    // Sockets allocated by the application (bit n = socket n), see `allocateSocket`
+    uint8_t socket_allocated = 0;
+
+    // Sockets with a TCP disconnect in progress (bit n = socket n), see `socketCloseAsync`
+    uint8_t close_pending = 0;
+
+    // Sockets with a TIMEOUT acknowledged while waiting for SEND_OK, reported by `socketEvents` (bit n = socket n)
+    uint8_t timeout_events = 0;
+
+    // Sockets with TCP keep-alive (bit n = socket n), see `setKeepAlive` & `sendKeepAlive`
+    uint8_t keep_alive = 0;
+
+    // Shadow copy of the interface network configuration (read without SPI access)
+    struct InterfaceNetwork {
+        bool valid = false;
+        IP_t source_ip = {};
+        IP_t subnet_mask = {};
+        IP_t gateway = {};
+    } interface_network;
+
+    // Host-side state of each socket
+    struct SocketState {
+        // Deferred RECV - read pointer is kept on the host until the threshold or timeout is reached
+        uint16_t rx_threshold = 0;      // bytes, 0 = disabled (RECV after every receive)
+        uint32_t rx_timeout_ms = 0;
+        uint16_t rx_pointer = 0;        // host-side read pointer, only valid if rx_pending > 0
+        uint16_t rx_pending = 0;        // bytes read, but not yet acknowledged with RECV
+        uint32_t rx_pending_since = 0;  // time of the first not acknowledged read
+        // TX Buffer - write pointer & free space are tracked on the host while the socket is open
+        bool tx_pointer_valid = false;
+        uint16_t tx_pointer = 0;        // host-side write pointer (incl. not yet sent data)
+        uint16_t tx_free = 0;           // lower bound of the free space (only grows while sending)
+        uint16_t tx_pending = 0;        // bytes written, but not yet sent with SEND
+        // Send coalescing - SEND is delayed until the threshold or timeout is reached
+        uint16_t tx_threshold = 0;      // bytes, 0 = disabled (SEND after every send)
+        uint32_t tx_timeout_ms = 0;
+        uint32_t tx_pending_since = 0;  // time of the first not sent write
+        uint32_t tx_dropped = 0;        // coalesced bytes dropped after "send" reported them (see "sendDropped")
+        // Timeouts of socket operations (see "setSocketTimeout"), indexed by SocketTimeout
+        uint32_t timeout_ms[3] = {3000, 3000, 3000};
+        // Non-blocking open (see "socketOpenAsync"), advanced in "poll"
+        OpenState open_state = Open_Idle;
+        SocketMode open_mode = UDP;
+        uint32_t open_deadline = 0;     // time limit of the current step
+        // Non-blocking close (see "socketCloseAsync"): CLOSE is issued at the deadline
+        uint32_t close_deadline = 0;
+        // Destination IP & Port last written (skip writing the same destination again), cleared on open & close
+        bool dest_valid = false;
+        IP_t dest_ip = {};
+        Port_t dest_port = 0;
+    };
+    SocketState socket_state[Socket_MAX];
+
 
     //=============================
     // Functions
@@ -243,6 +429,39 @@ private:
     void socketCommand(uint8_t socket_n, SocketCommandReg command);
     SocketStatusReg socketStatusReg(uint8_t socket_n);
     bool waitSocketStatus(uint8_t socket_n, SocketStatusReg status, float timeout);
+    bool socketSendable(uint8_t socket_n);
+    bool socketReceivable(uint8_t socket_n);
+
+    // SEND Command & Completion
+    void sendCommand(uint8_t socket_n);
+    bool waitSendComplete(uint8_t socket_n);
+
+    // RX Buffer read pointer (host-side or W5500 register)
+    uint16_t rxReadPointer(uint8_t socket_n);
+    void rxAdvance(uint8_t socket_n, uint16_t read_pointer, uint16_t len);
+    bool rxDeferralExpired(uint8_t socket_n);
+
+    // TX Buffer write pointer (host-side or W5500 register)
+    uint16_t txWritePointer(uint8_t socket_n);
+    bool txAdvance(uint8_t socket_n, uint16_t len, bool buffer_full);
+    void txCommit(uint8_t socket_n);
+    void txDiscard(uint8_t socket_n);
+    bool txCoalescingExpired(uint8_t socket_n);
+
+    // Non-blocking open - state machine
+    uint8_t socketModeValue(SocketMode mode);
+    void openCommand(uint8_t socket_n);
+    void openStep(uint8_t socket_n);
+    void closeStep(uint8_t socket_n);
+    SocketStatusReg closeStart(uint8_t socket_n);
+    uint32_t socketDeadline(uint8_t socket_n, SocketTimeout operation);
+
+    uint16_t receiveUdp(uint8_t socket_n, uint8_t *data, uint16_t len, DatagramInfo *info, bool update_destination);
+    void resetSocketState(uint8_t socket_n);
+
+    // Destination IP & Port in a single burst (cached)
+    void wrSocketDest(uint8_t socket_n, const IP_t dest_ip, Port_t dest_port);
+    void updateSocketDest(uint8_t socket_n, const IP_t dest_ip, Port_t dest_port);
 
     // Common & Scoket - Register Read/Write
     void commonReg(CommonOffsetAddr offset, bool write, uint8_t *data, uint16_t len);
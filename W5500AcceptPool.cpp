@@ -0,0 +1,148 @@
+#include "W5500AcceptPool.h"
+
+/**
+ * @brief Constructor
+ * @param pool socket pool providing the listening sockets
+ * @param owner owner ID of the sockets in the socket pool (non-zero)
+ * @param port TCP port to listen on
+ */
+W5500AcceptPool::W5500AcceptPool(W5500SocketPool &pool, uint8_t owner, W5500::Port_t port) : pool(pool), owner(owner), port(port) {}
+
+
+//=======================================================
+// Listeners
+//=======================================================
+
+/**
+ * @brief Add listening sockets on a chip (opened immediately & re-armed in "poll")
+ * @param chip_index index of the chip in the socket pool
+ * @param count number of listening sockets on this chip
+ * @return true if all listeners were added (not necessarily opened), false if Listener_MAX was exceeded
+ */
+bool W5500AcceptPool::addListeners(uint8_t chip_index, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (listener_count >= Listener_MAX) {
+            return false;
+        }
+        Listener &listener = listeners[listener_count++];
+        listener = Listener{chip_index, W5500SocketPool::Handle{}};
+        arm(listener);
+    }
+    return true;
+}
+
+/**
+ * @brief Move established connections to the backlog & re-arm the listeners (call regularly)
+ * One register read per chip with listeners, plus a read & acknowledge per listener with events.
+ */
+void W5500AcceptPool::poll() {
+    uint32_t chips_read = 0;
+    uint8_t chip_events[W5500SocketPool::Chip_MAX];
+    for (uint8_t i = 0; i < listener_count; i++) {
+        Listener &listener = listeners[i];
+        if (!listener.handle.valid()) {
+            arm(listener);
+            continue;
+        }
+        // common socket interrupt register (once per chip)
+        const uint32_t chip_bit = static_cast<uint32_t>(1) << listener.chip_index;
+        if (!(chips_read & chip_bit)) {
+            chip_events[listener.chip_index] = listener.handle.chip->pendingEvents();
+            chips_read |= chip_bit;
+        }
+        if (!(chip_events[listener.chip_index] & (1 << listener.handle.socket_n)) || (backlog_count >= Backlog_MAX)) {
+            continue;
+        }
+        if (checkListener(listener)) {
+            arm(listener);
+        }
+    }
+}
+
+
+//=======================================================
+// Accept
+//=======================================================
+
+/**
+ * @brief Take an established connection from the backlog
+ * @param handle socket handle of the connection (output)
+ * @param new_owner owner ID of the connection in the socket pool (release it with this ID)
+ * @return true if a connection was accepted, false if there is none
+ */
+bool W5500AcceptPool::accept(W5500SocketPool::Handle &handle, uint8_t new_owner) {
+    while (backlog_count > 0) {
+        W5500SocketPool::Handle &connection = backlog[backlog_head];
+        backlog_head = (backlog_head + 1) % Backlog_MAX;
+        backlog_count--;
+        if (pool.transfer(connection, owner, new_owner)) {
+            handle = connection;
+            return true;
+        }
+    }
+    return false;
+}
+
+// number of established connections not yet accepted
+uint8_t W5500AcceptPool::pending() const {
+    return backlog_count;
+}
+
+// number of armed listeners
+uint8_t W5500AcceptPool::listening() const {
+    uint8_t armed = 0;
+    for (uint8_t i = 0; i < listener_count; i++) {
+        if (listeners[i].handle.valid()) {
+            armed++;
+        }
+    }
+    return armed;
+}
+
+/**
+ * @brief Close all listeners & not accepted connections, remove all listeners
+ */
+void W5500AcceptPool::close() {
+    pool.releaseAll(owner);
+    listener_count = 0;
+    backlog_count = 0;
+}
+
+
+//=======================================================
+// Private Functions
+//=======================================================
+
+// acquire a socket & open it as TCP server (left unarmed on failure, retried in "poll")
+bool W5500AcceptPool::arm(Listener &listener) {
+    if (!pool.acquireOn(listener.chip_index, owner, listener.handle)) {
+        return false;
+    }
+    W5500 &eth = *listener.handle.chip;
+    eth.setSocketSource(listener.handle.socket_n, port);
+    if (!eth.socketOpen(listener.handle.socket_n, W5500::TCP_Server)) {
+        pool.release(listener.handle, owner, false);
+        return false;
+    }
+    return true;
+}
+
+// handle the events of a listener, return true if it has to be re-armed
+bool W5500AcceptPool::checkListener(Listener &listener) {
+    W5500 &eth = *listener.handle.chip;
+    const uint8_t socket_n = listener.handle.socket_n;
+    const uint8_t events = eth.socketEvents(socket_n);
+    if (events & W5500::Event_Connected) {
+        // hand the connection over to the backlog (even if it was closed again in the meantime)
+        backlog[(backlog_head + backlog_count) % Backlog_MAX] = listener.handle;
+        backlog_count++;
+        listener.handle = W5500SocketPool::Handle{};
+        return true;
+    }
+    if ((events & (W5500::Event_Disconnected | W5500::Event_Timeout)) && (eth.socketStatus(socket_n) == W5500::Closed)) {
+        // listener failed (e.g. connection reset during the handshake)
+        pool.release(listener.handle, owner, false);
+        return true;
+    }
+    return false;
+}
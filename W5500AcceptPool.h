@@ -0,0 +1,71 @@
+#ifndef W5500_ACCEPT_POOL_H
+#define W5500_ACCEPT_POOL_H
+
+#include "W5500SocketPool.h"
+
+
+/**
+ * @brief Multiple TCP server sockets listening on the same port
+ *
+ * A W5500 socket serves a single connection, so a single listening socket refuses further clients
+ * until the connection is closed. The accept pool keeps K sockets (from a "W5500SocketPool", possibly on
+ * multiple chips) listening on the same port. Established connections are handed to the application
+ * with "accept" and the listener is immediately replaced by a new socket from the socket pool.
+ * The pool checks the common socket interrupt register once per chip ("W5500::pendingEvents"),
+ * only listeners with events are read - their socket events are consumed by the accept pool.
+ */
+class W5500AcceptPool {
+public:
+    //=============================
+    // Constants
+    static constexpr uint8_t Listener_MAX = 16;
+    static constexpr uint8_t Backlog_MAX = 16;  // established connections not yet accepted
+
+    //=============================
+    // Constructor
+
+    W5500AcceptPool(W5500SocketPool &pool, uint8_t owner, W5500::Port_t port);
+
+    //=============================
+    // Functions
+
+    bool addListeners(uint8_t chip_index, uint8_t count);
+    void poll();
+
+    bool accept(W5500SocketPool::Handle &handle, uint8_t new_owner);
+    uint8_t pending() const;
+    uint8_t listening() const;
+    void close();
+
+private:
+    //=============================
+    // Type Definitions
+
+    struct Listener {
+        uint8_t chip_index;
+        W5500SocketPool::Handle handle;  // invalid: not armed
+    };
+
+    //=============================
+    // Variables
+
+    W5500SocketPool &pool;
+    const uint8_t owner;
+    const W5500::Port_t port;
+
+    Listener listeners[Listener_MAX];
+    uint8_t listener_count = 0;
+
+    // established connections (ring buffer)
+    W5500SocketPool::Handle backlog[Backlog_MAX];
+    uint8_t backlog_head = 0;
+    uint8_t backlog_count = 0;
+
+    //=============================
+    // Functions
+
+    bool arm(Listener &listener);
+    bool checkListener(Listener &listener);
+};
+
+#endif // W5500_ACCEPT_POOL_H
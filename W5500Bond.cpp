@@ -0,0 +1,219 @@
+#include "W5500Bond.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor
+ * @param primary Chip used initially
+ * @param backup Chip taking over if the link of the primary is down
+ * @param check_interval Time between PHY link checks in seconds (default: 10 ms)
+ */
+W5500Bond::W5500Bond(W5500 &primary, W5500 &backup, float check_interval)
+    : chips{&primary, &backup}, check_interval_ms(static_cast<uint32_t>(check_interval * 1000)) {}
+
+
+//=======================================================
+// Socket registration
+//=======================================================
+
+// UDP socket - the destination may change later (e.g. "receive" with UpdateDestination) & is migrated as well
+void W5500Bond::addUdp(uint8_t socket_n, W5500::Port_t source_port, const W5500::IP_t dest_ip, W5500::Port_t dest_port) {
+    add(socket_n, W5500::UDP, source_port, dest_ip, dest_port);
+}
+
+// TCP client socket - reconnects to the destination after a failover
+void W5500Bond::addTcpClient(uint8_t socket_n, W5500::Port_t source_port, const W5500::IP_t dest_ip, W5500::Port_t dest_port) {
+    add(socket_n, W5500::TCP_Client, source_port, dest_ip, dest_port);
+}
+
+// TCP server socket - listens on the backup chip after a failover
+void W5500Bond::addTcpServer(uint8_t socket_n, W5500::Port_t source_port) {
+    const W5500::IP_t no_ip = {0, 0, 0, 0};
+    add(socket_n, W5500::TCP_Server, source_port, no_ip, 0);
+}
+
+/**
+ * @brief Open all registered sockets on the active chip
+ */
+void W5500Bond::begin() {
+    for (uint8_t socket_n = 0; socket_n < W5500::Socket_MAX; socket_n++) {
+        if (sockets[socket_n].used) {
+            openSocket(active(), socket_n);
+        }
+    }
+    last_check = active().timeMs();
+}
+
+
+//=======================================================
+// Monitoring
+//=======================================================
+
+/**
+ * @brief Advance the socket opens & check the PHY links (once per check interval), fail over if necessary
+ * @return true if a failover was performed
+ * Re-opens dropped sockets on the active chip while its link is up.
+ */
+bool W5500Bond::poll() {
+    active().poll();
+    const uint32_t now = active().timeMs();
+    if (migrating && allOpen()) {
+        migrating = false;
+        failover_metrics.last_latency_ms = now - migration_start;
+        failover_metrics.max_latency_ms = std::max(failover_metrics.max_latency_ms, failover_metrics.last_latency_ms);
+    }
+    if ( (now - last_check) < check_interval_ms) {
+        return false;
+    }
+    last_check = now;
+
+    if (active().phyLinkUp()) {
+        link_down = false;
+        reopenDropped();
+        return false;
+    }
+    if (! link_down) {
+        link_down = true;
+        link_down_since = now;
+    }
+    if (! standby().phyLinkUp()) {
+        return false;
+    }
+    return failover();
+}
+
+/**
+ * @brief Migrate all registered sockets to the standby chip (also usable for a manual switch-over)
+ * @return true after the migration - the sockets are opened without waiting ("poll" completes the opens,
+ * see "W5500::openState" & re-opens TCP clients that could not connect)
+ */
+bool W5500Bond::failover() {
+    W5500 &failed = active();
+    W5500 &target = standby();
+    // latency counts from the link-down detection (manual switch-over: from now)
+    const uint32_t start = link_down ? link_down_since : failed.timeMs();
+
+    for (uint8_t socket_n = 0; socket_n < W5500::Socket_MAX; socket_n++) {
+        if (! sockets[socket_n].used) {
+            continue;
+        }
+        saveUdpDest(failed, socket_n);
+        openSocket(target, socket_n);
+    }
+    // close the sockets on the failed chip (no TCP disconnect without link)
+    for (uint8_t socket_n = 0; socket_n < W5500::Socket_MAX; socket_n++) {
+        if (sockets[socket_n].used) {
+            failed.socketAbort(socket_n);
+        }
+    }
+    active_index ^= 1;
+    link_down = false;
+
+    // latency is recorded by "poll" once all sockets are open
+    migrating = true;
+    migration_start = start;
+    failover_metrics.failovers++;
+    failover_metrics.last_failover = target.timeMs();
+    return true;
+}
+
+
+//=======================================================
+// Status
+//=======================================================
+
+// chip currently carrying the sockets
+W5500 &W5500Bond::active() {
+    return *chips[active_index];
+}
+
+// chip taking over on failover
+W5500 &W5500Bond::standby() {
+    return *chips[active_index ^ 1];
+}
+
+// true if the backup chip is active
+bool W5500Bond::onBackup() const {
+    return active_index != 0;
+}
+
+// failover statistics
+const W5500Bond::Metrics &W5500Bond::metrics() const {
+    return failover_metrics;
+}
+
+
+//=======================================================
+// Private
+//=======================================================
+
+void W5500Bond::add(uint8_t socket_n, W5500::SocketMode mode, W5500::Port_t source_port, const W5500::IP_t dest_ip, W5500::Port_t dest_port) {
+    if (socket_n >= W5500::Socket_MAX) {
+        return;
+    }
+    SocketConfig &config = sockets[socket_n];
+    config.used = true;
+    config.mode = mode;
+    config.source_port = source_port;
+    memcpy(config.dest_ip, dest_ip, sizeof(W5500::IP_t));
+    config.dest_port = dest_port;
+}
+
+// configure & open a registered socket on the given chip (non-blocking, a TCP connect doesn't delay the other sockets)
+void W5500Bond::openSocket(W5500 &eth, uint8_t socket_n) {
+    const SocketConfig &config = sockets[socket_n];
+    eth.setSocketSource(socket_n, config.source_port);
+    if (config.mode != W5500::TCP_Server) {
+        eth.setSocketDest(socket_n, config.dest_ip, config.dest_port);
+    }
+    eth.socketOpenAsync(socket_n, config.mode);
+}
+
+// keep the current UDP destination of a socket (the registers remain readable without link & after closing)
+void W5500Bond::saveUdpDest(W5500 &eth, uint8_t socket_n) {
+    SocketConfig &config = sockets[socket_n];
+    if (config.mode == W5500::UDP) {
+        eth.regSocketAddress(socket_n, W5500::DestinationIP, false, config.dest_ip, sizeof(W5500::IP_t));
+        config.dest_port = eth.getSocketPort(socket_n, W5500::DestinationPort);
+    }
+}
+
+// open registered sockets again that were closed on the active chip (not while an open is in progress)
+void W5500Bond::reopenDropped() {
+    W5500 &eth = active();
+    for (uint8_t socket_n = 0; socket_n < W5500::Socket_MAX; socket_n++) {
+        const SocketConfig &config = sockets[socket_n];
+        if (! config.used) {
+            continue;
+        }
+        bool closed;
+        switch (eth.openState(socket_n)) {
+            case W5500::Open_Closing:
+            case W5500::Open_Init:
+            case W5500::Open_Connecting:
+                continue;
+            case W5500::Open_Failed:
+                closed = true;
+                break;
+            default:
+                // a half-closed TCP connection is left to the application (data may still be received)
+                closed = (config.mode == W5500::UDP) ? (eth.socketStatus(socket_n) == W5500::Closed)
+                                                     : (eth.tcpState(socket_n) == W5500::TCP_Closed);
+                break;
+        }
+        if (closed) {
+            saveUdpDest(eth, socket_n);
+            openSocket(eth, socket_n);
+        }
+    }
+}
+
+// all registered sockets are open on the active chip (no SPI access)
+bool W5500Bond::allOpen() {
+    for (uint8_t socket_n = 0; socket_n < W5500::Socket_MAX; socket_n++) {
+        if (sockets[socket_n].used && (active().openState(socket_n) != W5500::Open_Established)) {
+            return false;
+        }
+    }
+    return true;
+}
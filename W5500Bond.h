@@ -0,0 +1,95 @@
+#ifndef W5500_BOND_H
+#define W5500_BOND_H
+
+#include "W5500.h"
+
+
+/**
+ * @brief Active/Backup bonding of two W5500 Ethernet Controllers
+ * 
+ * The registered sockets are opened on the active chip (initially the primary).
+ * The PHY link of both chips is checked periodically (a single register read per chip & interval).
+ * If the link of the active chip is down while the backup link is up, the sockets are migrated:
+ * UDP sockets are opened with their current destination, TCP servers listen & TCP clients reconnect
+ * on the backup chip, before the sockets on the failed chip are closed.
+ * Registered sockets that are closed on the active chip (e.g. TCP connection lost, connect failed, closed by
+ * the application) are opened again at the next link check (one status read per socket & interval).
+ * Both chips need their own network configuration (see `W5500::setInterfaceNetwork`).
+ * Failover is not reverted automatically - the primary becomes the backup.
+ */
+class W5500Bond {
+public:
+    //=============================
+    // Type Definitions
+
+    struct Metrics {
+        uint16_t failovers;         // number of failovers
+        uint32_t last_latency_ms;   // link-down detection until all sockets are open on the new chip (last failover)
+        uint32_t max_latency_ms;    // maximum of last_latency_ms
+        uint32_t last_failover;     // time of the last failover (W5500::timeMs)
+    };
+
+    //=============================
+    // Constructor
+
+    W5500Bond(W5500 &primary, W5500 &backup, float check_interval = 0.01);
+
+    //=============================
+    // Functions
+
+    // Socket registration (same socket number on both chips)
+    void addUdp(uint8_t socket_n, W5500::Port_t source_port, const W5500::IP_t dest_ip, W5500::Port_t dest_port);
+    void addTcpClient(uint8_t socket_n, W5500::Port_t source_port, const W5500::IP_t dest_ip, W5500::Port_t dest_port);
+    void addTcpServer(uint8_t socket_n, W5500::Port_t source_port);
+    void begin();
+
+    // Monitoring (call regularly)
+    bool poll();
+    bool failover();
+
+    // Status
+    W5500 &active();
+    W5500 &standby();
+    bool onBackup() const;
+    const Metrics &metrics() const;
+
+private:
+    //=============================
+    // Type Definitions
+
+    struct SocketConfig {
+        bool used;
+        W5500::SocketMode mode;
+        W5500::Port_t source_port;
+        W5500::IP_t dest_ip;
+        W5500::Port_t dest_port;
+    };
+
+    //=============================
+    // Variables
+
+    W5500 *chips[2];
+    uint8_t active_index = 0;
+    const uint32_t check_interval_ms;
+    uint32_t last_check = 0;
+
+    // Failover latency: link-down detection until all sockets are open (see "Metrics")
+    bool link_down = false;
+    uint32_t link_down_since = 0;
+    bool migrating = false;
+    uint32_t migration_start = 0;
+
+    SocketConfig sockets[W5500::Socket_MAX] = {};
+    Metrics failover_metrics = {};
+
+    //=============================
+    // Functions
+
+    void add(uint8_t socket_n, W5500::SocketMode mode, W5500::Port_t source_port, const W5500::IP_t dest_ip, W5500::Port_t dest_port);
+    void openSocket(W5500 &eth, uint8_t socket_n);
+    void saveUdpDest(W5500 &eth, uint8_t socket_n);
+    void reopenDropped();
+    bool allOpen();
+};
+
+#endif // W5500_BOND_H
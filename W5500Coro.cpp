@@ -0,0 +1,257 @@
+#include "W5500Coro.h"
+
+#ifdef W5500_CORO_AVAILABLE
+
+#include <algorithm>
+
+//=======================================================
+// Frame Pool
+//=======================================================
+
+namespace {
+    union Frame {
+        Frame *next_free;
+        alignas(max_align_t) uint8_t data[W5500_CORO_FRAME_SIZE];
+    };
+    Frame frames[W5500_CORO_FRAME_COUNT];
+    Frame *free_list = nullptr;
+    uint16_t frames_used = 0;   // frames never allocated yet start at frames[frames_used]
+}
+
+/**
+ * @brief Take a frame from the pool
+ * @param size size of the coroutine frame
+ * @return frame, nullptr if larger than W5500_CORO_FRAME_SIZE or no frame is free
+ */
+void *W5500FramePool::allocate(size_t size) {
+    if (size > sizeof(Frame)) {
+        return nullptr;
+    }
+    if (free_list != nullptr) {
+        Frame *frame = free_list;
+        free_list = frame->next_free;
+        return frame;
+    }
+    if (frames_used < W5500_CORO_FRAME_COUNT) {
+        return &frames[frames_used++];
+    }
+    return nullptr;
+}
+
+// return a frame to the pool
+void W5500FramePool::release(void *frame) {
+    Frame *released = static_cast<Frame *>(frame);
+    released->next_free = free_list;
+    free_list = released;
+}
+
+// number of free frames
+uint16_t W5500FramePool::available() {
+    uint16_t count = W5500_CORO_FRAME_COUNT - frames_used;
+    for (const Frame *frame = free_list; frame != nullptr; frame = frame->next_free) {
+        count++;
+    }
+    return count;
+}
+
+
+//=======================================================
+// Scheduler
+//=======================================================
+
+/**
+ * @brief Constructor
+ * @param chips Array of W5500 pointers (must remain valid during the lifetime of the scheduler)
+ * @param chip_count Number of chips in the array (max. Chip_MAX)
+ */
+W5500Scheduler::W5500Scheduler(W5500 *chips[], uint8_t chip_count)
+    : chips(chips), chip_count(std::min(chip_count, Chip_MAX)) {}
+
+/**
+ * @brief Resume the coroutines whose operations completed (call regularly)
+ * Also performs the maintenance of all chips (see "W5500::poll", e.g. non-blocking opens).
+ */
+void W5500Scheduler::poll() {
+    if (chip_count == 0) {
+        return;
+    }
+    uint8_t pending[Chip_MAX];
+    uint8_t acknowledged[Chip_MAX] = {};
+    for (uint8_t c = 0; c < chip_count; c++) {
+        chips[c]->poll();
+        pending[c] = (waiters != nullptr) ? chips[c]->pendingEvents() : 0;
+    }
+    const uint32_t now = chips[0]->timeMs();
+    const bool check = (now - last_check) >= Check_Interval_ms;
+    if (check) {
+        last_check = now;
+    }
+
+    // resumed coroutines may wait again - they are added to the new list
+    W5500Waiter *list = waiters;
+    waiters = nullptr;
+    while (list != nullptr) {
+        W5500Waiter &waiter = *list;
+        list = waiter.next;
+        const uint8_t socket_bit = 1 << waiter.socket_n;
+        const bool event = (pending[waiter.chip_index] & socket_bit) != 0;
+        if (event && !(acknowledged[waiter.chip_index] & socket_bit)) {
+            // acknowledge once - all waiters of the socket are checked
+            waiter.eth->socketEvents(waiter.socket_n);
+            acknowledged[waiter.chip_index] |= socket_bit;
+        }
+        if ((event || check || waiter.every_poll) && waiter.ready(waiter)) {
+            waiter.handle.resume();
+        } else {
+            waiter.next = waiters;
+            waiters = &waiter;
+        }
+    }
+}
+
+// number of suspended operations
+uint16_t W5500Scheduler::waiting() const {
+    uint16_t count = 0;
+    for (const W5500Waiter *waiter = waiters; waiter != nullptr; waiter = waiter->next) {
+        count++;
+    }
+    return count;
+}
+
+W5500 &W5500Scheduler::chip(uint8_t chip_index) {
+    return *chips[chip_index];
+}
+
+// suspend until "waiter.ready" returns true
+void W5500Scheduler::wait(W5500Waiter &waiter) {
+    waiter.next = waiters;
+    waiters = &waiter;
+}
+
+
+//=======================================================
+// Socket
+//=======================================================
+
+/**
+ * @brief Constructor
+ * @param scheduler scheduler resuming the operations
+ * @param chip_index index of the chip in the scheduler
+ * @param socket_n Socket number
+ */
+W5500Socket::W5500Socket(W5500Scheduler &scheduler, uint8_t chip_index, uint8_t socket_n)
+    : scheduler(&scheduler), chip_index(chip_index), socket_n(socket_n) {}
+
+/**
+ * @brief Open the socket (non-blocking, see "W5500::socketOpenAsync")
+ * @param mode Mode of the socket
+ * @return awaitable, true if opened successfully
+ */
+W5500Socket::Connect W5500Socket::connect(W5500::SocketMode mode) {
+    udp = (mode == W5500::UDP);
+    return Connect{waiter([](W5500Waiter &waiter) {
+        switch (waiter.eth->openState(waiter.socket_n)) {
+            case W5500::Open_Closing:
+            case W5500::Open_Init:
+            case W5500::Open_Connecting:
+                return false;
+            default:
+                return true;
+        }
+    }, true), mode};
+}
+
+/**
+ * @brief Receive data - waits until data is available
+ * @param data buffer
+ * @param len size of the buffer
+ * @return awaitable, number of bytes received (0: TCP connection closed)
+ */
+W5500Socket::Read W5500Socket::read(uint8_t *data, uint16_t len) {
+    return Read{waiter([](W5500Waiter &waiter) {
+        Read &read = static_cast<Read &>(waiter);
+        W5500 &eth = *read.eth;
+        if (eth.receiveAvailable(read.socket_n) > 0) {
+            read.received = eth.receive(read.socket_n, read.data, read.len);
+            return true;
+        }
+        // end of stream: peer closed & all data read
+        const W5500::TcpState state = eth.tcpState(read.socket_n);
+        return (state == W5500::TCP_PeerClosed) || ((state == W5500::TCP_Closed) && !read.udp);
+    }, false), data, len, 0, udp};
+}
+
+/**
+ * @brief Send all data - waits for free space in the TX buffer & for the SEND_OK of the previous chunk (TCP)
+ * @param data data to send
+ * @param len number of bytes
+ * @return awaitable, true if all data was sent
+ */
+W5500Socket::WriteAll W5500Socket::writeAll(uint8_t *data, uint16_t len) {
+    return WriteAll{waiter([](W5500Waiter &waiter) {
+        WriteAll &write = static_cast<WriteAll &>(waiter);
+        W5500 &eth = *write.eth;
+        while (write.sent < write.len) {
+            // a previous SEND must be completed first - stay suspended instead of waiting in "send"
+            const uint16_t free_space = eth.sendCompleted(write.socket_n) ? eth.sendAvailable(write.socket_n) : 0;
+            if (free_space == 0) {
+                // not sendable anymore (connection closed) or wait for SEND_OK
+                const W5500::TcpState state = eth.tcpState(write.socket_n);
+                write.closed = (state == W5500::TCP_Closed) || (state == W5500::TCP_LocalClosed);
+                return write.closed;
+            }
+            const uint16_t chunk = std::min<uint16_t>(free_space, write.len - write.sent);
+            write.sent += eth.send(write.socket_n, write.data + write.sent, chunk);
+        }
+        return true;
+    }, false), data, len, 0, false};
+}
+
+/**
+ * @brief Close the socket (TCP disconnect in the background, see "W5500::socketCloseAsync")
+ */
+void W5500Socket::close() {
+    chip().socketCloseAsync(socket_n);
+}
+
+W5500 &W5500Socket::chip() {
+    return scheduler->chip(chip_index);
+}
+
+uint8_t W5500Socket::socket() const {
+    return socket_n;
+}
+
+// waiter of an operation on this socket (registered with the scheduler in "await_suspend")
+W5500Waiter W5500Socket::waiter(bool (*ready)(W5500Waiter &waiter), bool every_poll) {
+    return W5500Waiter{scheduler, &chip(), chip_index, socket_n, every_poll, ready, {}, nullptr};
+}
+
+
+//=============================
+// Awaitables
+
+// register with the scheduler (operation not completed immediately)
+void W5500Waiter::await_suspend(std::coroutine_handle<> h) {
+    handle = h;
+    scheduler->wait(*this);
+}
+
+bool W5500Socket::Connect::await_ready() {
+    // completed immediately if the PHY link is down
+    return !eth->socketOpenAsync(socket_n, mode);
+}
+
+bool W5500Socket::Connect::await_resume() {
+    return eth->openState(socket_n) == W5500::Open_Established;
+}
+
+uint16_t W5500Socket::Read::await_resume() {
+    return received;
+}
+
+bool W5500Socket::WriteAll::await_resume() {
+    return sent == len;
+}
+
+#endif // W5500_CORO_AVAILABLE
@@ -0,0 +1,188 @@
+#ifndef W5500_CORO_H
+#define W5500_CORO_H
+
+#include "W5500.h"
+
+// C++20 coroutines (host builds & MCU toolchains with coroutine support)
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define W5500_CORO_AVAILABLE 1
+
+#include <stddef.h>
+#include <coroutine>
+
+// Coroutine frames are taken from a fixed pool (no heap) - size & number of frames
+#ifndef W5500_CORO_FRAME_SIZE
+#define W5500_CORO_FRAME_SIZE 512
+#endif
+#ifndef W5500_CORO_FRAME_COUNT
+#define W5500_CORO_FRAME_COUNT 16
+#endif
+
+
+/**
+ * @brief Fixed pool of coroutine frames (W5500_CORO_FRAME_COUNT frames of W5500_CORO_FRAME_SIZE bytes)
+ * A coroutine with a larger frame (or without a free frame) is not started, see `W5500Task::started`.
+ */
+class W5500FramePool {
+public:
+    static void *allocate(size_t size);
+    static void release(void *frame);
+    static uint16_t available();
+};
+
+
+/**
+ * @brief Coroutine of a connection handler (return type), e.g.
+ * @code
+ * W5500Task echo(W5500Socket sock) {
+ *     if (!co_await sock.connect(W5500::TCP_Server)) co_return;
+ *     uint8_t buf[64];
+ *     while (uint16_t len = co_await sock.read(buf, sizeof(buf))) {
+ *         if (!co_await sock.writeAll(buf, len)) break;
+ *     }
+ *     sock.close();
+ * }
+ * @endcode
+ * The coroutine runs immediately until its first suspension & is resumed by `W5500Scheduler::poll`.
+ * Its frame is returned to the pool when it finishes.
+ */
+class W5500Task {
+public:
+    struct promise_type {
+        W5500Task get_return_object() noexcept { return W5500Task(true); }
+        static W5500Task get_return_object_on_allocation_failure() noexcept { return W5500Task(false); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}  // no exceptions used
+
+        static void *operator new(size_t size) noexcept { return W5500FramePool::allocate(size); }
+        static void operator delete(void *frame) noexcept { W5500FramePool::release(frame); }
+    };
+
+    // false if no frame was available (the coroutine did not run)
+    bool started() const { return is_started; }
+
+private:
+    explicit W5500Task(bool started) : is_started(started) {}
+    bool is_started;
+};
+
+
+class W5500Scheduler;
+
+/**
+ * @brief Suspended operation of a coroutine, resumed by `W5500Scheduler::poll` once `ready` returns true
+ * Lives in the coroutine frame (awaitables of `W5500Socket`), linked into the scheduler without heap.
+ */
+struct W5500Waiter {
+    W5500Scheduler *scheduler;
+    W5500 *eth;
+    uint8_t chip_index;
+    uint8_t socket_n;
+    bool every_poll;                        // check on every poll (no SPI access in "ready"), not only on events
+    bool (*ready)(W5500Waiter &waiter);     // try to complete the operation
+    std::coroutine_handle<> handle;
+    W5500Waiter *next;
+
+    bool await_ready() { return ready(*this); }
+    void await_suspend(std::coroutine_handle<> h);
+};
+
+
+/**
+ * @brief Resumes the coroutines waiting on the sockets of multiple chips
+ * One read of the common socket interrupt register per chip & poll - only waiters of sockets with events
+ * are checked (all waiters every Check_Interval_ms, e.g. for missed events).
+ * The scheduler reads & acknowledges the socket events (see `W5500::socketEvents`) of sockets with waiters.
+ */
+class W5500Scheduler {
+public:
+    //=============================
+    // Constants
+    static constexpr uint8_t Chip_MAX = 8;
+    static constexpr uint16_t Check_Interval_ms = 100;
+
+    //=============================
+    // Constructor
+
+    W5500Scheduler(W5500 *chips[], uint8_t chip_count);
+
+    //=============================
+    // Functions
+
+    void poll();
+    uint16_t waiting() const;
+    W5500 &chip(uint8_t chip_index);
+
+    // used by the awaitables of W5500Socket
+    void wait(W5500Waiter &waiter);
+
+private:
+    W5500 **chips;
+    const uint8_t chip_count;
+    W5500Waiter *waiters = nullptr;
+    uint32_t last_check = 0;
+};
+
+
+/**
+ * @brief Socket with awaitable operations (for coroutines, see `W5500Task`)
+ * Cheap to copy - e.g. passed by value to a connection handler. IP & Port configuration is required before "connect".
+ */
+class W5500Socket {
+public:
+    //=============================
+    // Awaitables (results of co_await)
+
+    // co_await: true if opened (UDP), listening (TCP_Server) or connected (TCP_Client)
+    struct Connect : W5500Waiter {
+        W5500::SocketMode mode;
+        bool await_ready();
+        bool await_resume();
+    };
+    // co_await: number of bytes received, 0 if the connection was closed by the peer
+    struct Read : W5500Waiter {
+        uint8_t *data;
+        uint16_t len;
+        uint16_t received;
+        bool udp;
+        uint16_t await_resume();
+    };
+    // co_await: true if all data was sent, false if the connection was closed before
+    struct WriteAll : W5500Waiter {
+        uint8_t *data;
+        uint16_t len;
+        uint16_t sent;
+        bool closed;
+        bool await_resume();
+    };
+
+    //=============================
+    // Constructor
+
+    W5500Socket(W5500Scheduler &scheduler, uint8_t chip_index, uint8_t socket_n);
+
+    //=============================
+    // Functions
+
+    Connect connect(W5500::SocketMode mode = W5500::TCP_Client);
+    Read read(uint8_t *data, uint16_t len);
+    WriteAll writeAll(uint8_t *data, uint16_t len);
+    void close();
+
+    W5500 &chip();
+    uint8_t socket() const;
+
+private:
+    W5500Scheduler *scheduler;
+    uint8_t chip_index;
+    uint8_t socket_n;
+    bool udp = false;   // opened in UDP mode (no end of stream)
+
+    W5500Waiter waiter(bool (*ready)(W5500Waiter &waiter), bool every_poll);
+};
+
+#endif // __cpp_impl_coroutine
+
+#endif // W5500_CORO_H
@@ -0,0 +1,117 @@
+#include "W5500Group.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor
+ * @param chips Array of W5500 pointers (must remain valid during the lifetime of the group)
+ * @param count Number of chips in the array (max. Chip_MAX)
+ */
+W5500Group::W5500Group(W5500 *chips[], uint8_t count) : chips(chips), count(std::min(count, Chip_MAX)) {}
+
+// number of chips in the group
+uint8_t W5500Group::size() const {
+    return count;
+}
+
+// chip with the given index
+W5500 &W5500Group::chip(uint8_t index) {
+    return *chips[index];
+}
+
+
+//=======================================================
+// Initialization & Status
+//=======================================================
+
+/**
+ * @brief Initialize all chips (like "W5500::init")
+ * Each initialization step is performed on all chips before waiting once,
+ * so the reset delays are not multiplied by the number of chips.
+ */
+void W5500Group::initAll() {
+    if (count == 0) {
+        return;
+    }
+    for (uint8_t step = 0; step < W5500::Init_Steps; step++) {
+        float delay = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            delay = std::max(delay, chips[i]->initStep(step));
+        }
+        chips[0]->sleep(delay);
+    }
+}
+
+/**
+ * @brief Get the PHY link status of all chips (one register read per chip)
+ * @return bit n set: link of chip n is up
+ */
+uint32_t W5500Group::linkStatusAll() {
+    uint32_t status = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (chips[i]->phyLinkUp()) {
+            status |= (static_cast<uint32_t>(1) << i);
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Collect the socket events of all chips & perform periodic maintenance ("W5500::poll")
+ * @param events Event table to fill
+ * @param max_events Size of the event table
+ * @return number of entries in the event table (one per socket with events)
+ * One register read per chip, plus a read & acknowledge for each socket with events.
+ * If the table is full, the remaining events are kept for the next call.
+ */
+uint16_t W5500Group::pollAll(Event events[], uint16_t max_events) {
+    uint16_t n = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        W5500 &eth = *chips[i];
+        eth.poll();
+        if (n >= max_events) {
+            continue;
+        }
+        const uint8_t pending = eth.pendingEvents();
+        for (uint8_t socket_n = 0; (socket_n < W5500::Socket_MAX) && (n < max_events); socket_n++) {
+            if (pending & (1 << socket_n)) {
+                events[n++] = Event{i, socket_n, eth.socketEvents(socket_n)};
+            }
+        }
+    }
+    return n;
+}
+
+
+//=======================================================
+// Bulk Socket Configuration
+//=======================================================
+
+// set RX & TX buffer size of a socket on all chips (see "W5500::setBufferSizeRx")
+void W5500Group::setBufferSizesAll(uint8_t socket_n, uint8_t rx_size_kB, uint8_t tx_size_kB) {
+    for (uint8_t i = 0; i < count; i++) {
+        chips[i]->setBufferSizeRx(socket_n, rx_size_kB);
+        chips[i]->setBufferSizeTx(socket_n, tx_size_kB);
+    }
+}
+
+// set the source port of a socket on all chips
+void W5500Group::setSocketSourceAll(uint8_t socket_n, W5500::Port_t source_port) {
+    for (uint8_t i = 0; i < count; i++) {
+        chips[i]->setSocketSource(socket_n, source_port);
+    }
+}
+
+// keep a socket open on all chips (see "W5500::socketKeepOpen")
+void W5500Group::socketKeepOpenAll(uint8_t socket_n, W5500::SocketMode mode) {
+    for (uint8_t i = 0; i < count; i++) {
+        chips[i]->socketKeepOpen(socket_n, mode);
+    }
+}
+
+// close a socket on all chips
+void W5500Group::socketCloseAll(uint8_t socket_n) {
+    for (uint8_t i = 0; i < count; i++) {
+        chips[i]->socketClose(socket_n);
+    }
+}
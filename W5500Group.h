@@ -0,0 +1,64 @@
+#ifndef W5500_GROUP_H
+#define W5500_GROUP_H
+
+#include "W5500.h"
+
+
+/**
+ * @brief Group of W5500 Ethernet Controllers
+ * 
+ * Operations on all chips of the group at once: initialization with shared reset delays,
+ * link status of all chips as bitmask, event polling into a compact table & bulk socket configuration.
+ * The chips are referenced by their index in the array given to the constructor.
+ */
+class W5500Group {
+public:
+    //=============================
+    // Type Definitions
+
+    // Entry of the event table (see `pollAll`)
+    struct Event {
+        uint8_t chip;       // index of the chip
+        uint8_t socket_n;   // socket number
+        uint8_t events;     // W5500::SocketEvent bits
+    };
+
+    //-----------------------------
+    // Constants
+    static constexpr uint8_t Chip_MAX = 32; // bitmask of `linkStatusAll`
+
+    //=============================
+    // Constructor
+
+    W5500Group(W5500 *chips[], uint8_t count);
+
+    //=============================
+    // Functions
+
+    uint8_t size() const;
+    W5500 &chip(uint8_t index);
+
+    //-----------------------------
+    // Initialization & Status
+
+    void initAll();
+    uint32_t linkStatusAll();
+    uint16_t pollAll(Event events[], uint16_t max_events);
+
+    //-----------------------------
+    // Bulk Socket Configuration (same socket on all chips)
+
+    void setBufferSizesAll(uint8_t socket_n, uint8_t rx_size_kB, uint8_t tx_size_kB);
+    void setSocketSourceAll(uint8_t socket_n, W5500::Port_t source_port);
+    void socketKeepOpenAll(uint8_t socket_n, W5500::SocketMode mode);
+    void socketCloseAll(uint8_t socket_n);
+
+private:
+    //=============================
+    // Variables
+
+    W5500 **chips;
+    const uint8_t count;
+};
+
+#endif // W5500_GROUP_H
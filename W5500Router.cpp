@@ -0,0 +1,190 @@
+#include "W5500Router.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor
+ * @param chips Array of W5500 pointers (must remain valid during the lifetime of the router)
+ * @param count Number of chips in the array
+ */
+W5500Router::W5500Router(W5500 *chips[], uint8_t count) : chips(chips), count(std::min(count, No_Route)) {}
+
+
+//=======================================================
+// Route Configuration
+//=======================================================
+
+/**
+ * @brief Add a route for the subnet of each chip (from its interface configuration)
+ * @param default_route add a default route (0.0.0.0/0) to the first chip with a gateway
+ * Chips without a source IP are skipped. Call again after changing the interface configuration.
+ */
+void W5500Router::seedInterfaces(bool default_route) {
+    bool default_added = !default_route;
+    for (uint8_t i = 0; i < count; i++) {
+        W5500::IP_t source_ip, subnet_mask, gateway;
+        chips[i]->getInterfaceNetwork(source_ip, subnet_mask, gateway);
+        if (toAddress(source_ip) == 0) {
+            continue;
+        }
+        // prefix length of the subnet mask (contiguous mask expected)
+        const uint8_t prefix_len = __builtin_popcount(toAddress(subnet_mask));
+        addRoute(source_ip, prefix_len, i);
+        if (!default_added && (toAddress(gateway) != 0)) {
+            const W5500::IP_t any = {0, 0, 0, 0};
+            default_added = addRoute(any, 0, i);
+        }
+    }
+}
+
+/**
+ * @brief Add (or replace) a route
+ * @param network network address (host bits are ignored)
+ * @param prefix_len prefix length (0-32)
+ * @param chip index of the egress chip
+ * @return true if the route was added, false if the table is full or the parameters are invalid
+ */
+bool W5500Router::addRoute(const W5500::IP_t network, uint8_t prefix_len, uint8_t chip) {
+    if ((prefix_len > 32) || (chip >= count)) {
+        return false;
+    }
+    const uint32_t mask = prefixMask(prefix_len);
+    const uint32_t masked = toAddress(network) & mask;
+    // replace an existing route
+    for (uint8_t i = 0; i < route_count; i++) {
+        if ((routes[i].prefix_len == prefix_len) && (routes[i].network == masked)) {
+            routes[i].chip = chip;
+            clearCache();
+            return true;
+        }
+    }
+    if (route_count >= Route_MAX) {
+        return false;
+    }
+    // insert after all routes with a longer or equal prefix
+    uint8_t pos = route_count;
+    while ((pos > 0) && (routes[pos - 1].prefix_len < prefix_len)) {
+        routes[pos] = routes[pos - 1];
+        pos--;
+    }
+    routes[pos] = Route{masked, mask, prefix_len, chip};
+    route_count++;
+    clearCache();
+    return true;
+}
+
+/**
+ * @brief Remove a route
+ * @param network network address (host bits are ignored)
+ * @param prefix_len prefix length (0-32)
+ * @return true if the route was removed, false if not found
+ */
+bool W5500Router::removeRoute(const W5500::IP_t network, uint8_t prefix_len) {
+    const uint32_t masked = toAddress(network) & prefixMask(prefix_len);
+    for (uint8_t i = 0; i < route_count; i++) {
+        if ((routes[i].prefix_len == prefix_len) && (routes[i].network == masked)) {
+            std::copy(&routes[i + 1], &routes[route_count], &routes[i]);
+            route_count--;
+            clearCache();
+            return true;
+        }
+    }
+    return false;
+}
+
+// remove all routes
+void W5500Router::clearRoutes() {
+    route_count = 0;
+    clearCache();
+}
+
+// number of routes in the table
+uint8_t W5500Router::routeCount() const {
+    return route_count;
+}
+
+
+//=======================================================
+// Lookup
+//=======================================================
+
+/**
+ * @brief Get the egress chip for a destination (longest prefix match)
+ * @param dest_ip destination IP address
+ * @return index of the chip, or No_Route
+ * No SPI access. O(1) for cached destinations, otherwise a scan of the (sorted) route table.
+ */
+uint8_t W5500Router::lookup(const W5500::IP_t dest_ip) {
+    const uint32_t dest = toAddress(dest_ip);
+    CacheEntry &entry = cache[cacheIndex(dest)];
+    if (!entry.valid || (entry.dest != dest)) {
+        entry = CacheEntry{true, dest, findRoute(dest)};
+    }
+    return entry.chip;
+}
+
+/**
+ * @brief Get the egress chip for a destination & allocate a free socket on it
+ * @param dest_ip destination IP address
+ * @param egress chip & socket number (output)
+ * @return true if successful, false if there is no route or no free socket on the egress chip
+ * The socket is allocated with "W5500::allocateSocket" (not opened) - free it with "release".
+ */
+bool W5500Router::select(const W5500::IP_t dest_ip, Egress &egress) {
+    const uint8_t chip = lookup(dest_ip);
+    if (chip == No_Route) {
+        return false;
+    }
+    uint8_t socket_n;
+    if (!chips[chip]->allocateSocket(socket_n)) {
+        return false;
+    }
+    egress = Egress{chip, socket_n};
+    return true;
+}
+
+/**
+ * @brief Release the socket of an egress selected by "select" (the socket is not closed)
+ * @param egress chip & socket number
+ */
+void W5500Router::release(const Egress &egress) {
+    if (egress.chip < count) {
+        chips[egress.chip]->releaseSocket(egress.socket_n);
+    }
+}
+
+
+//=======================================================
+// Private Functions
+//=======================================================
+
+// IP address as 32-bit number (first octet is the most significant byte)
+uint32_t W5500Router::toAddress(const W5500::IP_t ip) {
+    return (static_cast<uint32_t>(ip[0]) << 24) | (static_cast<uint32_t>(ip[1]) << 16) | (static_cast<uint32_t>(ip[2]) << 8) | ip[3];
+}
+
+// network mask of a prefix length (0-32)
+uint32_t W5500Router::prefixMask(uint8_t prefix_len) {
+    return (prefix_len == 0) ? 0 : (0xFFFFFFFF << (32 - std::min(prefix_len, (uint8_t)32)));
+}
+
+// cache slot of a destination (multiplicative hash)
+uint8_t W5500Router::cacheIndex(uint32_t dest) {
+    return ((dest * 2654435761u) >> 24) & (Cache_SIZE - 1);
+}
+
+// first (= longest) matching route
+uint8_t W5500Router::findRoute(uint32_t dest) const {
+    for (uint8_t i = 0; i < route_count; i++) {
+        if ((dest & routes[i].mask) == routes[i].network) {
+            return routes[i].chip;
+        }
+    }
+    return No_Route;
+}
+
+void W5500Router::clearCache() {
+    for (CacheEntry &entry : cache) {
+        entry.valid = false;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef W5500_ROUTER_H
+#define W5500_ROUTER_H
+
+#include "W5500.h"
+
+
+/**
+ * @brief Routing table selecting the egress W5500 for a destination IP
+ *
+ * Holds longest-prefix-match routes (network/prefix -> chip), seeded from the interface
+ * configuration of the chips ("W5500::getInterfaceNetwork", no SPI access after "setInterfaceNetwork").
+ * The routes are kept sorted by prefix length, so the first match is the longest prefix.
+ * Lookup results are stored in a small direct-mapped cache: repeated destinations are resolved in O(1),
+ * the cache is cleared whenever the routes change.
+ * The next hop (gateway) is resolved by the selected chip itself (its gateway & subnet registers).
+ */
+class W5500Router {
+public:
+    //=============================
+    // Type Definitions
+
+    // Egress chip & socket for a destination (see `select`)
+    struct Egress {
+        uint8_t chip;       // index of the chip
+        uint8_t socket_n;   // allocated socket number
+    };
+
+    //-----------------------------
+    // Constants
+    static constexpr uint8_t Route_MAX = 16;
+    static constexpr uint8_t Cache_SIZE = 64;   // power of 2
+    static constexpr uint8_t No_Route = 0xFF;   // returned by `lookup`
+
+    //=============================
+    // Constructor
+
+    W5500Router(W5500 *chips[], uint8_t count);
+
+    //=============================
+    // Functions
+
+    //-----------------------------
+    // Route Configuration
+
+    void seedInterfaces(bool default_route = true);
+    bool addRoute(const W5500::IP_t network, uint8_t prefix_len, uint8_t chip);
+    bool removeRoute(const W5500::IP_t network, uint8_t prefix_len);
+    void clearRoutes();
+    uint8_t routeCount() const;
+
+    //-----------------------------
+    // Lookup (per-packet path)
+
+    uint8_t lookup(const W5500::IP_t dest_ip);
+    bool select(const W5500::IP_t dest_ip, Egress &egress);
+    void release(const Egress &egress);
+
+private:
+    //=============================
+    // Type Definitions
+
+    struct Route {
+        uint32_t network;   // host byte order, masked
+        uint32_t mask;
+        uint8_t prefix_len;
+        uint8_t chip;
+    };
+    struct CacheEntry {
+        bool valid;
+        uint32_t dest;
+        uint8_t chip;       // No_Route is cached as well
+    };
+
+    //=============================
+    // Variables
+
+    W5500 **chips;
+    const uint8_t count;
+
+    Route routes[Route_MAX];    // sorted by prefix length (longest first)
+    uint8_t route_count = 0;
+    CacheEntry cache[Cache_SIZE] = {};
+
+    //=============================
+    // Functions
+
+    static uint32_t toAddress(const W5500::IP_t ip);
+    static uint32_t prefixMask(uint8_t prefix_len);
+    static uint8_t cacheIndex(uint32_t dest);
+    uint8_t findRoute(uint32_t dest) const;
+    void clearCache();
+};
+
+#endif // W5500_ROUTER_H
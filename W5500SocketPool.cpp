@@ -0,0 +1,166 @@
+#include "W5500SocketPool.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor
+ * @param chips Array of W5500 pointers (must remain valid during the lifetime of the pool)
+ * @param count Number of chips in the array (max. Chip_MAX)
+ */
+W5500SocketPool::W5500SocketPool(W5500 *chips[], uint8_t count) : chips(chips), count(std::min(count, Chip_MAX)) {
+    refresh();
+}
+
+
+//=======================================================
+// Acquire & Release
+//=======================================================
+
+/**
+ * @brief Acquire a free socket of any chip
+ * @param owner owner ID (non-zero)
+ * @param handle socket handle (output)
+ * @return true if a socket was acquired, false if no socket is free
+ * The socket is not opened or configured (see "W5500::setSocketSource", "W5500::socketOpen").
+ */
+bool W5500SocketPool::acquire(uint8_t owner, Handle &handle) {
+    if (chips_free == 0) {
+        // sockets may have finished closing (see "W5500::socketCloseAsync")
+        refresh();
+    }
+    while (chips_free != 0) {
+        if (acquireOn(__builtin_ctz(chips_free), owner, handle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Acquire a free socket of a specific chip
+ * @param chip_index index of the chip
+ * @param owner owner ID (non-zero)
+ * @param handle socket handle (output)
+ * @return true if a socket was acquired, false if no socket of this chip is free
+ */
+bool W5500SocketPool::acquireOn(uint8_t chip_index, uint8_t owner, Handle &handle) {
+    if ((chip_index >= count) || (owner == No_Owner)) {
+        return false;
+    }
+    W5500 &eth = *chips[chip_index];
+    uint8_t socket_n;
+    const bool allocated = eth.allocateSocket(socket_n);
+    if (eth.freeSockets() == 0) {
+        chips_free &= ~(static_cast<uint32_t>(1) << chip_index);
+    }
+    if (!allocated) {
+        return false;
+    }
+    owners[chip_index][socket_n] = owner;
+    handle = Handle{&eth, chip_index, socket_n};
+    return true;
+}
+
+/**
+ * @brief Close a socket & return it to the pool
+ * @param handle socket handle (invalidated on success)
+ * @param owner owner ID (must match the owner of the socket)
+ * @param graceful true: "W5500::socketCloseAsync" (TCP disconnect in the background, the socket is free once
+ * "W5500::poll" of the chip has completed the close), false: "W5500::socketAbort" (immediate)
+ * @return true if released, false if the handle is invalid or owned by someone else
+ */
+bool W5500SocketPool::release(Handle &handle, uint8_t owner, bool graceful) {
+    if (!handle.valid() || (ownerOf(handle) != owner) || (owner == No_Owner)) {
+        return false;
+    }
+    if (graceful) {
+        handle.chip->socketCloseAsync(handle.socket_n);
+    } else {
+        handle.chip->socketAbort(handle.socket_n);
+    }
+    owners[handle.chip_index][handle.socket_n] = No_Owner;
+    handle.chip->releaseSocket(handle.socket_n);
+    chips_free |= (static_cast<uint32_t>(1) << handle.chip_index);
+    handle = Handle{};
+    return true;
+}
+
+/**
+ * @brief Close & release all sockets of an owner
+ * @param owner owner ID
+ * @param graceful see "release"
+ * @return number of released sockets
+ */
+uint16_t W5500SocketPool::releaseAll(uint8_t owner, bool graceful) {
+    uint16_t released = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t socket_n = 0; socket_n < W5500::Socket_MAX; socket_n++) {
+            Handle handle{chips[i], i, socket_n};
+            if ((owners[i][socket_n] == owner) && release(handle, owner, graceful)) {
+                released++;
+            }
+        }
+    }
+    return released;
+}
+
+/**
+ * @brief Hand a socket over to another owner (the socket stays open)
+ * @param handle socket handle
+ * @param owner current owner ID
+ * @param new_owner new owner ID (non-zero)
+ * @return true if transferred, false if the handle is invalid or owned by someone else
+ */
+bool W5500SocketPool::transfer(const Handle &handle, uint8_t owner, uint8_t new_owner) {
+    if ((ownerOf(handle) != owner) || (owner == No_Owner) || (new_owner == No_Owner)) {
+        return false;
+    }
+    owners[handle.chip_index][handle.socket_n] = new_owner;
+    return true;
+}
+
+
+//=======================================================
+// Status
+//=======================================================
+
+/**
+ * @brief Get the owner of a socket
+ * @param handle socket handle
+ * @return owner ID, or No_Owner if the socket is free (or reserved outside of the pool) or the handle does not
+ * belong to this pool
+ */
+uint8_t W5500SocketPool::ownerOf(const Handle &handle) const {
+    if (!handle.valid() || (handle.chip_index >= count) || (handle.socket_n >= W5500::Socket_MAX)) {
+        return No_Owner;
+    }
+    if (handle.chip != chips[handle.chip_index]) {
+        return No_Owner;
+    }
+    return owners[handle.chip_index][handle.socket_n];
+}
+
+/**
+ * @brief Get the number of free sockets of all chips
+ * @return number of free sockets
+ */
+uint16_t W5500SocketPool::available() const {
+    uint16_t free_count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        free_count += __builtin_popcount(chips[i]->freeSockets());
+    }
+    return free_count;
+}
+
+/**
+ * @brief Update the bitmask of chips with free sockets
+ * Required if sockets were released outside of the pool (e.g. "W5500::releaseSocket").
+ */
+void W5500SocketPool::refresh() {
+    chips_free = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (chips[i]->freeSockets() != 0) {
+            chips_free |= (static_cast<uint32_t>(1) << i);
+        }
+    }
+}
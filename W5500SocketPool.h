@@ -0,0 +1,68 @@
+#ifndef W5500_SOCKET_POOL_H
+#define W5500_SOCKET_POOL_H
+
+#include "W5500.h"
+
+
+/**
+ * @brief Pool of the sockets of multiple W5500 Ethernet Controllers
+ *
+ * Sockets are handed out as handles (chip & socket number) instead of fixed socket numbers.
+ * Each socket has an owner (any non-zero ID chosen by the application), only the owner can release it.
+ * Acquire & release are O(1): a bitmask of chips with free sockets selects the chip,
+ * the chip selects the socket from its own free-bitmask ("W5500::allocateSocket").
+ * Released sockets are closed automatically. A graceful release disconnects in the background: the socket
+ * returns to the pool only once "W5500::poll" of its chip has completed the close (call it regularly).
+ * Sockets with a fixed purpose can be excluded with "W5500::reserveSocket" before creating the pool.
+ */
+class W5500SocketPool {
+public:
+    //=============================
+    // Type Definitions
+
+    // Socket handle
+    struct Handle {
+        W5500 *chip = nullptr;  // nullptr = invalid handle
+        uint8_t chip_index = 0; // index of the chip in the pool
+        uint8_t socket_n = 0;   // socket number
+
+        bool valid() const { return chip != nullptr; }
+    };
+
+    //-----------------------------
+    // Constants
+    static constexpr uint8_t Chip_MAX = 32; // bitmask of chips with free sockets
+    static constexpr uint8_t No_Owner = 0;
+
+    //=============================
+    // Constructor
+
+    W5500SocketPool(W5500 *chips[], uint8_t count);
+
+    //=============================
+    // Functions
+
+    // Acquire & Release
+    bool acquire(uint8_t owner, Handle &handle);
+    bool acquireOn(uint8_t chip_index, uint8_t owner, Handle &handle);
+    bool release(Handle &handle, uint8_t owner, bool graceful = true);
+    uint16_t releaseAll(uint8_t owner, bool graceful = true);
+    bool transfer(const Handle &handle, uint8_t owner, uint8_t new_owner);
+
+    // Status
+    uint8_t ownerOf(const Handle &handle) const;
+    uint16_t available() const;
+    void refresh();
+
+private:
+    //=============================
+    // Variables
+
+    W5500 **chips;
+    const uint8_t count;
+
+    uint32_t chips_free = 0;    // bit n set: chip n has (probably) a free socket
+    uint8_t owners[Chip_MAX][W5500::Socket_MAX] = {};
+};
+
+#endif // W5500_SOCKET_POOL_H
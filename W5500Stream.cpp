@@ -0,0 +1,190 @@
+#include "W5500Stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @brief Constructor
+ * @param eth W5500 the socket belongs to
+ * @param socket_n Socket number (opened & maintained by the user, e.g. "socketKeepOpen")
+ * @param rx_buffer Read-ahead buffer
+ * @param rx_size Size of the read-ahead buffer (must not be 0)
+ * @param tx_buffer Write-behind buffer
+ * @param tx_size Size of the write-behind buffer (must not be 0)
+ */
+W5500Stream::W5500Stream(W5500 &eth, uint8_t socket_n, uint8_t *rx_buffer, uint16_t rx_size, uint8_t *tx_buffer, uint16_t tx_size)
+    : eth(eth), socket_n(socket_n), rx_buffer(rx_buffer), rx_size(rx_size), tx_buffer(tx_buffer), tx_size(tx_size) {
+#ifndef ARDUINO
+    setg(reinterpret_cast<char *>(rx_buffer), reinterpret_cast<char *>(rx_buffer), reinterpret_cast<char *>(rx_buffer));
+    setp(reinterpret_cast<char *>(tx_buffer), reinterpret_cast<char *>(tx_buffer) + tx_size);
+#endif
+}
+
+#ifdef ARDUINO
+//=======================================================
+// Stream
+//=======================================================
+
+/**
+ * @brief Number of bytes available for reading
+ * @return bytes in the read-ahead buffer, refilled from the socket once it is empty
+ */
+int W5500Stream::available() {
+    if (rx_pos == rx_len) {
+        rx_len = fill();
+        rx_pos = 0;
+    }
+    return rx_len - rx_pos;
+}
+
+// read a single byte, -1 if nothing is available
+int W5500Stream::read() {
+    if (available() == 0) {
+        return -1;
+    }
+    return rx_buffer[rx_pos++];
+}
+
+// read a single byte without consuming it, -1 if nothing is available
+int W5500Stream::peek() {
+    if (available() == 0) {
+        return -1;
+    }
+    return rx_buffer[rx_pos];
+}
+
+
+//=======================================================
+// Print
+//=======================================================
+
+// write a single byte, 0 if the buffer is full & nothing could be sent
+size_t W5500Stream::write(uint8_t data) {
+    return write(&data, 1);
+}
+
+/**
+ * @brief Write data into the write-behind buffer
+ * @param data Data to write (not modified)
+ * @param len Length of the data
+ * @return number of bytes written, less than len if the W5500 TX buffer is full or the socket is not connected
+ * The buffer is sent only once it is full, use "flush" to send it earlier.
+ */
+size_t W5500Stream::write(const uint8_t *data, size_t len) {
+    size_t written = 0;
+    while (written < len) {
+        if (tx_len == tx_size) {
+            const uint16_t sent = drain(tx_len);
+            if (sent == 0) {
+                break; // W5500 TX buffer full or socket not connected
+            }
+            tx_len -= sent;
+        }
+        const uint16_t n = std::min<size_t>(len - written, tx_size - tx_len);
+        memcpy(tx_buffer + tx_len, data + written, n);
+        tx_len += n;
+        written += n;
+    }
+    return written;
+}
+
+// free space in the write-behind buffer
+int W5500Stream::availableForWrite() {
+    return tx_size - tx_len;
+}
+
+/**
+ * @brief Send the write-behind buffer (blocks until sent or the socket is disconnected)
+ */
+void W5500Stream::flush() {
+    while (tx_len > 0) {
+        const uint16_t sent = drain(tx_len);
+        if ( (sent == 0) && (! sendable()) ) {
+            tx_len = 0; // socket disconnected -> drop buffered data
+            break;
+        }
+        tx_len -= sent;
+    }
+    eth.flush(socket_n);
+}
+
+#else
+//=======================================================
+// std::streambuf
+//=======================================================
+
+// refill the get area - blocks until data is received or the socket is disconnected
+W5500Stream::int_type W5500Stream::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    uint16_t len;
+    while ( (len = fill()) == 0) {
+        if (! eth.socketConnected(socket_n)) {
+            return traits_type::eof();
+        }
+    }
+    char *begin = reinterpret_cast<char *>(rx_buffer);
+    setg(begin, begin, begin + len);
+    return traits_type::to_int_type(*gptr());
+}
+
+// send (part of) the put area to make space for ch - blocks until space is available or the socket is disconnected
+W5500Stream::int_type W5500Stream::overflow(int_type ch) {
+    const uint16_t len = pptr() - pbase();
+    uint16_t sent = 0;
+    while ( (len > 0) && ( (sent = drain(len)) == 0) ) {
+        if (! sendable()) {
+            return traits_type::eof();
+        }
+    }
+    char *begin = reinterpret_cast<char *>(tx_buffer);
+    setp(begin, begin + tx_size);
+    pbump(len - sent);
+    if (! traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+// send the complete put area
+int W5500Stream::sync() {
+    while (pptr() > pbase()) {
+        if (traits_type::eq_int_type(overflow(traits_type::eof()), traits_type::eof())) {
+            return -1;
+        }
+    }
+    eth.flush(socket_n);
+    return 0;
+}
+
+// bytes available without blocking (get area is empty)
+std::streamsize W5500Stream::showmanyc() {
+    return eth.receiveAvailable(socket_n);
+}
+
+#endif
+
+//=======================================================
+// Buffer Operations
+//=======================================================
+
+// read as much as fits into the RX buffer with a single "receive"
+uint16_t W5500Stream::fill() {
+    return eth.receive(socket_n, rx_buffer, rx_size);
+}
+
+// send the first len bytes of the TX buffer, move the remaining bytes to the front
+uint16_t W5500Stream::drain(uint16_t len) {
+    const uint16_t sent = eth.send(socket_n, tx_buffer, len);
+    memmove(tx_buffer, tx_buffer + sent, len - sent);
+    return sent;
+}
+
+// connection can still send (also after the peer closed) - no socket maintenance, a
+// half-closed connection must not be disconnected while buffered data is pending
+bool W5500Stream::sendable() {
+    const W5500::TcpState state = eth.tcpState(socket_n);
+    return (state == W5500::TCP_Established) || (state == W5500::TCP_PeerClosed);
+}
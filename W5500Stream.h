@@ -0,0 +1,88 @@
+#ifndef W5500_STREAM_H
+#define W5500_STREAM_H
+
+#include "W5500.h"
+
+#ifndef ARDUINO
+#include <streambuf>
+#endif
+
+
+/**
+ * @brief Buffered stream over a W5500 socket
+ * 
+ * Arduino: implements `Stream`, host builds: implements `std::streambuf` (e.g. for `std::iostream`).
+ * Data is read ahead into the RX buffer and written behind into the TX buffer (both provided by the user),
+ * so byte-wise access costs SPI frames once per buffer instead of once per byte.
+ * Intended for TCP sockets. Buffered TX data is sent when the TX buffer is full or on `flush()` / `sync()`.
+ */
+#ifdef ARDUINO
+class W5500Stream : public Stream {
+#else
+class W5500Stream : public std::streambuf {
+#endif
+public:
+    //=============================
+    // Constructor
+
+    W5500Stream(W5500 &eth, uint8_t socket_n, uint8_t *rx_buffer, uint16_t rx_size, uint8_t *tx_buffer, uint16_t tx_size);
+
+#ifdef ARDUINO
+    //=============================
+    // Stream
+
+    int available();
+    int read();
+    int peek();
+
+    //=============================
+    // Print
+
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t len);
+    using Print::write;
+    int availableForWrite();
+    void flush();
+
+#else
+protected:
+    //=============================
+    // std::streambuf
+
+    int_type underflow() override;
+    int_type overflow(int_type ch) override;
+    int sync() override;
+    std::streamsize showmanyc() override;
+
+#endif
+    //=============================
+    //=============================
+private:
+    //=============================
+    // Variables
+
+    W5500 &eth;
+    const uint8_t socket_n;
+
+    // User provided buffers
+    uint8_t * const rx_buffer;
+    const uint16_t rx_size;
+    uint8_t * const tx_buffer;
+    const uint16_t tx_size;
+
+#ifdef ARDUINO
+    // Buffer state (host builds use the std::streambuf pointers)
+    uint16_t rx_pos = 0;    // next byte to read
+    uint16_t rx_len = 0;    // bytes in RX buffer
+    uint16_t tx_len = 0;    // bytes in TX buffer
+#endif
+
+    //=============================
+    // Functions
+
+    uint16_t fill();
+    uint16_t drain(uint16_t len);
+    bool sendable();
+};
+
+#endif // W5500_STREAM_H